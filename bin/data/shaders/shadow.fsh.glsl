@@ -1,18 +1,44 @@
 //
 uniform sampler2D tex_source;
 uniform sampler2DShadow tex_shadow;
+uniform vec4 shadow_splits;
 varying vec4 light_diffuse;
+varying float eye_depth;
 
 void main(void)
 {
     vec4 pix_source = texture2D(tex_source, gl_TexCoord[0].st);
-    vec4 pix_shadow = shadow2DProj(tex_shadow, gl_TexCoord[1]);
-    vec3 tmp = max(vec3(0.2, 0.2, 0.2), pix_shadow.rgb);
-    if (any(lessThan(gl_TexCoord[1].st, vec2(0.0, 0.0))) ||
-        any(greaterThan(gl_TexCoord[1].st, vec2(1.0, 1.0))))
+
+    // pick cascade by distance, cascades are 2x2 tiles of tex_shadow
+    vec4 coord;
+    vec2 tile;
+    if (eye_depth < shadow_splits.x)
+    {
+        coord = gl_TexCoord[1];
+        tile = vec2(0.0, 0.0);
+    }
+    else if (eye_depth < shadow_splits.y)
+    {
+        coord = gl_TexCoord[2];
+        tile = vec2(0.5, 0.0);
+    }
+    else
     {
-        tmp = vec3(1.0, 1.0, 1.0);
+        coord = gl_TexCoord[3];
+        tile = vec2(0.0, 0.5);
     }
+    coord /= coord.q;
+
+    vec3 tmp = vec3(1.0, 1.0, 1.0);
+    if (eye_depth < shadow_splits.z &&
+        all(greaterThanEqual(coord.st, vec2(0.0, 0.0))) &&
+        all(lessThanEqual(coord.st, vec2(1.0, 1.0))))
+    {
+        coord.st = coord.st * 0.5 + tile;
+        vec4 pix_shadow = shadow2D(tex_shadow, coord.stp);
+        tmp = max(vec3(0.2, 0.2, 0.2), pix_shadow.rgb);
+    }
+
     vec4 result;
     result.rgb = (gl_LightSource[1].ambient.rgb + light_diffuse.rgb * tmp) * pix_source.rgb;
     result.a = pix_source.a;
@@ -1,16 +1,23 @@
 //
 varying vec4 light_diffuse;
+varying float eye_depth;
 
 void main(void)
 {
     vec4 ecPosition  = gl_ModelViewMatrix * gl_Vertex;
-    vec4 shadowCoord;
-    shadowCoord.s = dot( ecPosition, gl_EyePlaneS[1] );
-    shadowCoord.t = dot( ecPosition, gl_EyePlaneT[1] );
-    shadowCoord.p = dot( ecPosition, gl_EyePlaneR[1] );
-    shadowCoord.q = dot( ecPosition, gl_EyePlaneQ[1] );
     gl_TexCoord[0] = gl_MultiTexCoord0;
-    gl_TexCoord[1] = shadowCoord;
+
+    // one shadow coordinate per cascade
+    for (int i = 1; i <= 3; i++)
+    {
+        vec4 shadowCoord;
+        shadowCoord.s = dot( ecPosition, gl_EyePlaneS[i] );
+        shadowCoord.t = dot( ecPosition, gl_EyePlaneT[i] );
+        shadowCoord.p = dot( ecPosition, gl_EyePlaneR[i] );
+        shadowCoord.q = dot( ecPosition, gl_EyePlaneQ[i] );
+        gl_TexCoord[i] = shadowCoord;
+    }
+    eye_depth = -ecPosition.z;
 
     gl_Position = gl_ProjectionMatrix * ecPosition;
 
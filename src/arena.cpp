@@ -0,0 +1,79 @@
+#include <cstring>
+
+#include "arena.h"
+
+static const size_t ALIGNMENT = 8;
+
+Arena::Arena(size_t blockSize) : m_block(0), m_blockSize(blockSize), m_current(NULL), m_left(0)
+{
+}
+
+Arena::~Arena()
+{
+    clear();
+}
+
+void* Arena::allocate(size_t size)
+{
+    size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    if (size > m_left)
+    {
+        if (size > m_blockSize / 4)
+        {
+            // big allocations get own block, current block stays usable
+            char* block = new char [size];
+            m_big.push_back(block);
+            return block;
+        }
+        if (m_current != NULL)
+        {
+            m_block++;
+        }
+        if (m_block == m_blocks.size())
+        {
+            m_blocks.push_back(new char [m_blockSize]);
+        }
+        m_current = m_blocks[m_block];
+        m_left = m_blockSize;
+    }
+
+    void* result = m_current;
+    m_current += size;
+    m_left -= size;
+    return result;
+}
+
+const char* Arena::copy(const char* str, size_t length)
+{
+    char* result = static_cast<char*>(allocate(length + 1));
+    memcpy(result, str, length);
+    result[length] = 0;
+    return result;
+}
+
+void Arena::clear()
+{
+    reset();
+    for each_const(vector<char*>, m_blocks, iter)
+    {
+        delete [] *iter;
+    }
+    m_blocks.clear();
+}
+
+void Arena::reset()
+{
+    for each_const(vector<char*>, m_big, iter)
+    {
+        delete [] *iter;
+    }
+    m_big.clear();
+    m_block = 0;
+    m_current = NULL;
+    m_left = 0;
+}
+
+size_t Arena::used() const
+{
+    return m_current == NULL ? 0 : m_block * m_blockSize + (m_blockSize - m_left);
+}
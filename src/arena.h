@@ -0,0 +1,31 @@
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#include "common.h"
+
+// allocates from big blocks, everything is freed at once
+// or rewound with reset to reuse same blocks again
+class Arena : public NoCopy
+{
+public:
+    Arena(size_t blockSize = 64 * 1024);
+    ~Arena();
+
+    void* allocate(size_t size); // aligned to 8 bytes
+    const char* copy(const char* str, size_t length); // zero terminated copy
+
+    void clear();
+    void reset(); // keeps blocks, frees only oversized allocations
+
+    size_t used() const;
+
+private:
+    vector<char*> m_blocks;
+    vector<char*> m_big;
+    size_t        m_block;
+    size_t        m_blockSize;
+    char*         m_current;
+    size_t        m_left;
+};
+
+#endif
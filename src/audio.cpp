@@ -1,3 +1,5 @@
+#include <GL/glfw.h>
+
 #include "openal_includes.h"
 
 #include "audio.h"
@@ -5,12 +7,60 @@
 #include "music.h"
 #include "sound_buffer.h"
 #include "sound.h"
+#include "loader.h"
 
 template <class Audio> Audio* System<Audio>::instance = NULL;
 
 static ALCdevice* device;
 static ALCcontext* context;
 
+// less than one 250ms music buffer
+static const double MUSIC_THREAD_SLEEP = 0.05;
+
+static const int MAX_DECODE_THREADS = 4;
+
+struct DecodeJobs
+{
+    vector<SoundData>* sounds;
+    size_t             next;
+    GLFWmutex          mutex;
+};
+
+static void GLFWCALL decodeThread(void* arg)
+{
+    DecodeJobs* jobs = static_cast<DecodeJobs*>(arg);
+    while (true)
+    {
+        glfwLockMutex(jobs->mutex);
+        size_t idx = jobs->next++;
+        glfwUnlockMutex(jobs->mutex);
+
+        if (idx >= jobs->sounds->size())
+        {
+            break;
+        }
+
+        SoundData& sound = (*jobs->sounds)[idx];
+        try
+        {
+            decodeSound(sound);
+        }
+        catch (const string& error)
+        {
+            sound.error = error;
+        }
+    }
+}
+
+static void GLFWCALL musicThread(void* arg)
+{
+    Audio* audio = static_cast<Audio*>(arg);
+    while (audio->decodeMusic())
+    {
+        glfwSleep(MUSIC_THREAD_SLEEP);
+    }
+}
+
 void audio_setup()
 {
     clog << "Initializing audio." << endl;
@@ -48,17 +98,33 @@ void audio_finish()
     alcCloseDevice(device);
 }
 
-Audio::Audio() : m_device(NULL), m_context(NULL) 
+Audio::Audio() : m_device(NULL), m_context(NULL), m_musicThread(-1), m_musicMutex(NULL), 
+    m_musicCond(NULL), m_decoding(NULL), m_quit(false)
 {
 #ifndef __linux__
     audio_setup();
 #endif
     m_device = device;
     m_context = context;
+
+    OggDecoder::setReadAhead(Config::instance->m_audio.stream_buffer * 1024);
+
+    m_musicMutex = glfwCreateMutex();
+    m_musicCond = glfwCreateCond();
+    m_musicThread = glfwCreateThread(musicThread, this);
+    if (m_musicThread < 0)
+    {
+        throw Exception("Failed to create music thread");
+    }
 }
 
 Audio::~Audio()
 {
+    m_quit = true;
+    glfwWaitThread(m_musicThread, GLFW_WAIT);
+    glfwDestroyCond(m_musicCond);
+    glfwDestroyMutex(m_musicMutex);
+
 #ifndef __linux__
     audio_finish();
 #endif
@@ -66,16 +132,42 @@ Audio::~Audio()
     m_context = NULL;
 }
 
+struct MusicLoad
+{
+    const string* filename;
+    Music*        music;
+};
+
 Music* Audio::loadMusic(const string& filename)
 {
-    Music* music = *m_music.insert(new Music(filename)).first;
+    MusicLoad load = { &filename, NULL };
+    Loader::runOnMain(createMusic, &load);
+    return load.music;
+}
+
+void Audio::createMusic(void* arg)
+{
+    MusicLoad* load = static_cast<MusicLoad*>(arg);
+    Music* music = new Music(*load->filename);
+
+    glfwLockMutex(instance->m_musicMutex);
+    instance->m_music.insert(music);
+    glfwUnlockMutex(instance->m_musicMutex);
+
     alSourcef(music->m_source, AL_GAIN, Config::instance->m_audio.music_vol/15.0f);
-    return music;
+    load->music = music;
 }
 
 void Audio::unloadMusic(Music* music)
 {
+    glfwLockMutex(m_musicMutex);
     m_music.erase(music);
+    while (m_decoding == music)
+    {
+        glfwWaitCond(m_musicCond, m_musicMutex, GLFW_INFINITY);
+    }
+    glfwUnlockMutex(m_musicMutex);
+
     delete music;
 }
 
@@ -90,6 +182,68 @@ SoundBuffer* Audio::loadSound(const string& filename)
     return m_soundBuf.insert(make_pair(filename, new SoundBuffer(filename))).first->second;
 }
 
+void Audio::preloadSounds(const StringVector& filenames)
+{
+    vector<SoundData> sounds;
+    set<string> queued;
+    for each_const(StringVector, filenames, iter)
+    {
+        const string& filename = *iter;
+        if (foundIn(m_soundBuf, filename) || !queued.insert(filename).second)
+        {
+            continue;
+        }
+
+        SoundBuffer* cached = SoundBuffer::loadCached(filename);
+        if (cached != NULL)
+        {
+            m_soundBuf.insert(make_pair(filename, cached));
+        }
+        else
+        {
+            sounds.push_back(SoundData(filename));
+        }
+    }
+
+    if (sounds.empty())
+    {
+        return;
+    }
+
+    DecodeJobs jobs;
+    jobs.sounds = &sounds;
+    jobs.next = 0;
+    jobs.mutex = glfwCreateMutex();
+
+    int count = std::min(std::min(glfwGetNumberOfProcessors(), MAX_DECODE_THREADS), static_cast<int>(sounds.size()));
+    vector<GLFWthread> threads;
+    for (int i = 1; i < count; i++)
+    {
+        GLFWthread thread = glfwCreateThread(decodeThread, &jobs);
+        if (thread >= 0)
+        {
+            threads.push_back(thread);
+        }
+    }
+    // main thread works too
+    decodeThread(&jobs);
+
+    for each_const(vector<GLFWthread>, threads, iter)
+    {
+        glfwWaitThread(*iter, GLFW_WAIT);
+    }
+    glfwDestroyMutex(jobs.mutex);
+
+    for each_const(vector<SoundData>, sounds, iter)
+    {
+        if (!iter->error.empty())
+        {
+            throw Exception(iter->error);
+        }
+        m_soundBuf.insert(make_pair(iter->name, new SoundBuffer(*iter)));
+    }
+}
+
 void Audio::unloadSound(SoundBuffer* soundBuf)
 {
     for each_(SoundBufferMap, m_soundBuf, iter)
@@ -103,6 +257,35 @@ void Audio::unloadSound(SoundBuffer* soundBuf)
     }
 }
 
+bool Audio::decodeMusic()
+{
+    glfwLockMutex(m_musicMutex);
+    m_decodeList.assign(m_music.begin(), m_music.end());
+    glfwUnlockMutex(m_musicMutex);
+
+    for each_const(vector<Music*>, m_decodeList, iter)
+    {
+        // music could be unloaded since list was copied
+        glfwLockMutex(m_musicMutex);
+        if (m_music.find(*iter) == m_music.end())
+        {
+            glfwUnlockMutex(m_musicMutex);
+            continue;
+        }
+        m_decoding = *iter;
+        glfwUnlockMutex(m_musicMutex);
+
+        (*iter)->decodeAhead();
+
+        glfwLockMutex(m_musicMutex);
+        m_decoding = NULL;
+        glfwBroadcastCond(m_musicCond);
+        glfwUnlockMutex(m_musicMutex);
+    }
+
+    return !m_quit;
+}
+
 void Audio::update()
 {
     for each_(MusicSet, m_music, iter)
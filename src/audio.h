@@ -30,18 +30,32 @@ public:
     void unloadMusic(Music* music);
 
     SoundBuffer* loadSound(const string& filename);
+    void preloadSounds(const StringVector& filenames); // decodes in parallel
     void unloadSound(SoundBuffer* soundBuf);
 
     Sound* newSound(bool interrupt = true);
 
     void update();
 
+    // called from audio thread, returns false when thread must quit
+    bool decodeMusic();
+
 private:
+    static void createMusic(void* arg); // on main thread
     ALCdevice*    m_device;
     ALCcontext*   m_context;
 
     MusicSet       m_music;
     SoundBufferMap m_soundBuf;
+
+    // music is decoded in separate thread, mutex guards only m_music
+    // and m_decoding, decoding itself runs without it
+    int            m_musicThread;
+    void*          m_musicMutex;
+    void*          m_musicCond;  // signaled when m_decoding is cleared
+    Music*         m_decoding;   // music being decoded, can't be deleted
+    vector<Music*> m_decodeList; // audio thread copy of m_music
+    volatile bool  m_quit;
 };
 
 #endif
@@ -141,5 +141,5 @@ void Ball::renderShadow(const Vector& lightPosition) const
         pos.z = lp.z - t * delta.z;
     }
 
-    Video::instance->renderSimpleShadow(0.2f, pos, m_levelCollision, Vector(0.2f, 0.2f, 0.2f, 0.7f));
+    Video::instance->addSimpleShadow(this, 0.2f, pos, m_levelCollision, Vector(0.2f, 0.2f, 0.2f, 0.7f));
 }
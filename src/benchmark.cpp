@@ -0,0 +1,320 @@
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+
+#include "benchmark.h"
+#include "game.h"
+#include "world.h"
+#include "camera.h"
+#include "network.h"
+#include "player.h"
+#include "profile.h"
+#include "config.h"
+#include "timer.h"
+#include "random.h"
+#include "file.h"
+#include "xml.h"
+#include "version.h"
+#include "utilities.h"
+#include "memory_budget.h"
+#include "profiler.h"
+
+// simulation step of every frame, independent of real frame time
+static const float FRAME_STEP = 1.0f / 60.0f;
+static const unsigned int BENCHMARK_SEED = 12345;
+
+static const string CAMERA_PATH_FILE = "/data/level/camera_path.xml";
+static const string RESULTS_FILE = "/benchmark.csv";
+
+// render passes timed on GPU by ProfileZone and their result columns
+static const char* GPU_PASSES[][2] = {
+    { "Shadow pass 1",  "gpu_shadow1_ms" },
+    { "Shadow pass 2",  "gpu_shadow2_ms" },
+    { "SkyBox::render", "gpu_skybox_ms" },
+    { "Grass::render",  "gpu_grass_ms" },
+    { "HDR::begin",     "gpu_hdr_begin_ms" },
+    { "HDR::end",       "gpu_hdr_end_ms" },
+    { "HDR::render",    "gpu_hdr_render_ms" },
+};
+
+float  g_benchmarkSeconds = 0.0f;
+string g_benchmarkLevel;
+
+Benchmark::Benchmark(Profile* userProfile, float seconds) :
+    m_world(NULL),
+    m_unlockable(0),
+    m_frame(0),
+    m_frames(static_cast<int>(seconds / FRAME_STEP)),
+    m_last(0.0),
+    m_updateTime(0.0),
+    m_renderTime(0.0),
+    m_heapStart(0)
+{
+    Randoms::init(BENCHMARK_SEED);
+    Timer::setSimulated(true);
+
+    vector<Profile*> all;
+    for (int i = 0; i < 4; i++)
+    {
+        const vector<Profile*>& cpu = Game::instance->m_cpuProfiles[i];
+        all.insert(all.end(), cpu.begin(), cpu.end());
+    }
+
+    vector<Profile*> profiles;
+    while (profiles.size() < 4)
+    {
+        Profile* profile = all[Randoms::getIntN(static_cast<unsigned int>(all.size()))];
+        if (!foundIn(profiles, profile))
+        {
+            profiles.push_back(profile);
+        }
+    }
+    Network::instance->setAiProfiles(profiles);
+
+    m_world = new ::World(userProfile, m_unlockable, 0);
+    m_frameTimes.reserve(m_frames);
+
+    loadPath();
+}
+
+Benchmark::~Benchmark()
+{
+    Profiler::record(false);
+    delete m_world;
+    Timer::setSimulated(false);
+}
+
+void Benchmark::loadPath()
+{
+    XMLnode xml;
+    File::Reader in(CAMERA_PATH_FILE);
+    if (!in.is_open())
+    {
+        throw Exception("Camera path file '" + CAMERA_PATH_FILE + "' not found");
+    }
+    xml.load(in);
+    in.close();
+
+    for each_const(XMLnodes, xml.childs, iter)
+    {
+        const XMLnode& node = *iter;
+        if (node.name == "point")
+        {
+            CameraPoint point;
+            point.time = node.getAttribute<float>("time");
+            point.distance = node.getAttribute<float>("distance");
+            point.angleX = node.getAttribute<float>("angleX");
+            point.angleY = node.getAttribute<float>("angleY");
+            if (!m_path.empty() && point.time <= m_path.back().time)
+            {
+                throw Exception("Camera path points must be sorted by time");
+            }
+            m_path.push_back(point);
+        }
+        else
+        {
+            throw Exception("Invalid camera path, unknown node - " + node.name);
+        }
+    }
+
+    if (m_path.empty())
+    {
+        throw Exception("Camera path is empty");
+    }
+}
+
+void Benchmark::init()
+{
+    clog << "Benchmarking " << m_frames << " frames..." << endl;
+
+    m_world->init();
+    moveCamera(0.0f);
+
+    // zones are timed only while profiler is enabled
+    Profiler::record(true);
+}
+
+void Benchmark::control()
+{
+    // frame time is measured from control to control, so it includes swap
+    double now = Timer::precise();
+    if (m_frame > 0)
+    {
+        m_frameTimes.push_back(static_cast<float>(now - m_last));
+    }
+    else
+    {
+        m_heapStart = MemoryBudget::heapAllocations();
+    }
+    m_last = now;
+    m_frame++;
+
+    Timer::advance(FRAME_STEP);
+
+    // no input, all players are AI
+    for (size_t i = 0; i < m_world->m_localPlayers.size(); i++)
+    {
+        m_world->m_localPlayers[i]->control();
+    }
+}
+
+void Benchmark::update(float delta)
+{
+    double started = Timer::precise();
+    m_world->update(delta);
+    moveCamera(m_frame * FRAME_STEP);
+    m_updateTime += Timer::precise() - started;
+}
+
+void Benchmark::updateStep(float delta)
+{
+    double started = Timer::precise();
+    m_world->updateStep(delta);
+    m_updateTime += Timer::precise() - started;
+}
+
+void Benchmark::moveCamera(float time)
+{
+    const CameraPoint& last = m_path.back();
+    if (last.time > 0.0f)
+    {
+        time = std::fmod(time, last.time);
+    }
+
+    size_t i = 1;
+    while (i < m_path.size() && m_path[i].time < time)
+    {
+        i++;
+    }
+
+    if (i == m_path.size())
+    {
+        m_world->m_camera->setOrbit(last.distance, last.angleX, last.angleY);
+        return;
+    }
+
+    const CameraPoint& a = m_path[i - 1];
+    const CameraPoint& b = m_path[i];
+    float t = (time - a.time) / (b.time - a.time);
+    m_world->m_camera->setOrbit(
+        a.distance + (b.distance - a.distance) * t,
+        a.angleX + (b.angleX - a.angleX) * t,
+        a.angleY + (b.angleY - a.angleY) * t);
+}
+
+void Benchmark::prepare()
+{
+    double started = Timer::precise();
+    m_world->prepare();
+    m_renderTime += Timer::precise() - started;
+}
+
+void Benchmark::render() const
+{
+    double started = Timer::precise();
+    m_world->render();
+    m_renderTime += Timer::precise() - started;
+}
+
+State::Type Benchmark::progress()
+{
+    if (m_frame < m_frames)
+    {
+        return State::Current;
+    }
+
+    report();
+    return State::Quit;
+}
+
+static float percentile(const vector<float>& sorted, float p)
+{
+    if (sorted.empty())
+    {
+        return 0.0f;
+    }
+    return sorted[static_cast<size_t>(p * (sorted.size() - 1) + 0.5f)];
+}
+
+void Benchmark::report()
+{
+    vector<float> sorted = m_frameTimes;
+    std::sort(sorted.begin(), sorted.end());
+
+    double total = 0.0;
+    for each_const(vector<float>, sorted, iter)
+    {
+        total += *iter;
+    }
+    const float frames = static_cast<float>(m_frame);
+
+    const VideoConfig& video = Config::instance->m_video;
+
+    bool exists = File::exists(RESULTS_FILE);
+
+    std::ostringstream stream;
+    stream << std::fixed << std::setprecision(3);
+    if (!exists)
+    {
+        stream << "date,version,level,seconds,frames,fps,p50_ms,p95_ms,p99_ms,update_ms,render_ms,"
+               << "width,height,fullscreen,vsync,samples,anisotropy,shadow_type,shadowmap_size,"
+               << "show_fps,grass_density,terrain_detail,use_hdr";
+        for (size_t i = 0; i < sizeOfArray(GPU_PASSES); i++)
+        {
+            stream << ',' << GPU_PASSES[i][1];
+        }
+        stream << endl;
+    }
+    stream << getDateTime() << ',' << g_version << ','
+           << (g_benchmarkLevel.empty() ? "world.xml" : g_benchmarkLevel) << ','
+           << m_frames * FRAME_STEP << ',' << m_frame << ','
+           << (total > 0.0 ? sorted.size() / total : 0.0) << ','
+           << percentile(sorted, 0.50f) * 1000.0f << ','
+           << percentile(sorted, 0.95f) * 1000.0f << ','
+           << percentile(sorted, 0.99f) * 1000.0f << ','
+           << m_updateTime * 1000.0 / frames << ','
+           << m_renderTime * 1000.0 / frames << ','
+           << video.width << ',' << video.height << ',' << video.fullscreen << ','
+           << video.vsync << ',' << video.samples << ',' << video.anisotropy << ','
+           << video.shadow_type << ',' << video.shadowmap_size << ',' << video.show_fps << ','
+           << video.grass_density << ',' << video.terrain_detail << ',' << video.use_hdr;
+
+    std::ostringstream passes;
+    passes << std::fixed << std::setprecision(3);
+    for (size_t i = 0; i < sizeOfArray(GPU_PASSES); i++)
+    {
+        const double time = Profiler::getRecordedGPU(GPU_PASSES[i][0]);
+        stream << ',';
+        passes << (i == 0 ? "" : ", ") << GPU_PASSES[i][0] << ' ';
+        if (time < 0.0)
+        {
+            stream << "n/a";
+            passes << "n/a";
+        }
+        else
+        {
+            stream << time * 1000.0;
+            passes << time * 1000.0 << " ms";
+        }
+    }
+    stream << endl;
+    Profiler::record(false);
+
+    const string data = stream.str();
+    File::Writer out(RESULTS_FILE, true);
+    if (!out.is_open())
+    {
+        clog << "Failed to write benchmark results '" << RESULTS_FILE << "'" << endl;
+        return;
+    }
+    out.write(data.c_str(), data.size());
+    out.close();
+
+    clog << "Benchmark: " << m_frame << " frames, p50 " << percentile(sorted, 0.50f) * 1000.0f
+         << " ms, p95 " << percentile(sorted, 0.95f) * 1000.0f
+         << " ms, p99 " << percentile(sorted, 0.99f) * 1000.0f
+         << " ms, results appended to '" << RESULTS_FILE << "'" << endl;
+    clog << "Benchmark: " << static_cast<float>(MemoryBudget::heapAllocations() - m_heapStart) / frames
+         << " heap allocations per frame" << endl;
+    clog << "Benchmark: GPU " << passes.str() << endl;
+}
@@ -0,0 +1,57 @@
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+#include "common.h"
+#include "state.h"
+
+class World;
+class Profile;
+
+// set from command line: --benchmark <seconds> [level]
+extern float  g_benchmarkSeconds;
+extern string g_benchmarkLevel;
+
+struct CameraPoint
+{
+    float time;
+    float distance;
+    float angleX;
+    float angleY;
+};
+
+// renders AI only match with camera following path from data file,
+// simulation advances fixed time every frame, so every run renders
+// the same frames, only their rendering time differs
+class Benchmark : public State
+{
+public:
+    Benchmark(Profile* userProfile, float seconds);
+    ~Benchmark();
+
+    void init();
+    void control();
+    void update(float delta);
+    void updateStep(float delta);
+    void prepare();
+    void render() const;
+    State::Type progress();
+
+private:
+    ::World*            m_world;
+    int                 m_unlockable;
+    vector<CameraPoint> m_path;
+
+    int                 m_frame;
+    int                 m_frames;
+    double              m_last;
+    vector<float>       m_frameTimes;
+    double              m_updateTime;
+    mutable double      m_renderTime;
+    unsigned long       m_heapStart;
+
+    void loadPath();
+    void moveCamera(float time);
+    void report();
+};
+
+#endif
@@ -15,6 +15,7 @@ Body::Body(const string& id, const Level* level, const CollisionSet& collisions)
     m_collisions(collisions),
     m_soundable(false),
     m_important(false),
+    m_voice(-1),
     m_totalMass(0.0f),
     m_totalInertia(),
     m_collideable(NULL),
@@ -25,13 +26,14 @@ Body::Body(const string& id, const Level* level, const CollisionSet& collisions)
     createNewtonBody(Vector::Zero, Vector::Zero);
 }    
 
-Body::Body(const XMLnode& node, const Level* level):
+Body::Body(const XMLelement& node, const Level* level):
     m_id(""),
     m_newtonBody(NULL),
     m_matrix(),
     m_collisions(),
     m_soundable(false),
     m_important(false),
+    m_voice(-1),
     m_totalMass(0.0f),
     m_totalInertia(),
     m_collideable(NULL),
@@ -47,9 +49,9 @@ Body::Body(const XMLnode& node, const Level* level):
     Vector position(0.0f, 0.0f, 0.0f);
     Vector rotation(0.0f, 0.0f, 0.0f);
 
-    for each_const(XMLnodes, node.childs, iter)
+    for each_const(XMLelements, node.childs, iter)
     {
-        const XMLnode& node = *iter;
+        const XMLelement& node = *iter;
         if (node.name == "position")
         {
             position = node.getAttributesInVector("xyz");
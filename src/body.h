@@ -8,7 +8,7 @@
 
 class Collision;
 class Level;
-class XMLnode;
+class XMLelement;
 class Body;
 class UpdatePacket;
 
@@ -64,10 +64,11 @@ public:
 
     bool m_soundable;
     bool m_important;
+    int  m_voice; // playing voice in Properties, -1 if none
 
 protected:
 
-    Body(const XMLnode& node, const Level* level);
+    Body(const XMLelement& node, const Level* level);
 
     void createNewtonBody(const Vector& position,
                           const Vector& rotation);
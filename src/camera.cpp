@@ -3,6 +3,7 @@
 #include "world.h"
 #include "level.h"
 #include "body.h"
+#include "timer.h"
 
 static const float LOOK_SPEED = 0.2f;
 static const float MOVE_SPEED = 10.0f;
@@ -19,6 +20,8 @@ Camera::Camera(const Vector& pos, float angleX, float angleY) :
     m_lastDown(false),
     m_uuberCamera(false),
     m_lastUuberKey(false),
+    m_lastRecordKey(false),
+    m_recordStart(-1.0),
     m_defPos(-pos),
     m_defAngleX(angleX * DEG_IN_RAD),
     m_defAngleY(angleY * DEG_IN_RAD)
@@ -97,6 +100,23 @@ void Camera::control()
         m_lastUuberKey = false;
     }
 
+    // F9 logs orbit camera as point for /data/level/camera_path.xml
+    if (Input::instance->key(GLFW_KEY_F9) != m_lastRecordKey)
+    {
+        m_lastRecordKey = !m_lastRecordKey;
+        if (m_lastRecordKey && m_uuberCamera == false)
+        {
+            double now = Timer::precise();
+            if (m_recordStart < 0.0)
+            {
+                m_recordStart = now;
+            }
+            clog << "<point time=\"" << static_cast<float>(now - m_recordStart)
+                 << "\" distance=\"" << m_pos.magnitude()
+                 << "\" angleX=\"" << m_angleX / DEG_IN_RAD
+                 << "\" angleY=\"" << m_angleY / DEG_IN_RAD << "\"/>" << endl;
+        }
+    }
 }
 
 void Camera::update(float delta)
@@ -186,3 +206,18 @@ float Camera::angleY() const
 {
     return m_angleY;
 }
+
+const Matrix& Camera::matrix() const
+{
+    return m_matrix;
+}
+
+void Camera::setOrbit(float distance, float angleX, float angleY)
+{
+    m_uuberCamera = false;
+    m_pos = m_defPos;
+    m_pos.norm();
+    m_pos *= distance;
+    m_angleX = angleX * DEG_IN_RAD;
+    m_angleY = angleY * DEG_IN_RAD;
+}
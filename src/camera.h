@@ -16,6 +16,10 @@ public:
     void render() const;
 
     float angleY() const;
+    const Matrix& matrix() const;
+
+    // puts camera in orbit mode, angles in degrees
+    void setOrbit(float distance, float angleX, float angleY);
 
 private:
     Vector m_targetRotation;
@@ -32,6 +36,8 @@ private:
     bool   m_lastDown;
     bool   m_uuberCamera;
     bool   m_lastUuberKey;
+    bool   m_lastRecordKey;
+    double m_recordStart;
 
     const Vector m_defPos;
     const float  m_defAngleX;
@@ -3,6 +3,7 @@
 #include "input.h"
 #include "font.h"
 #include "network.h"
+#include "frame_allocator.h"
 
 Chat::Chat(const string& player, const Vector& color) :
     m_font(NULL),
@@ -118,7 +119,9 @@ void Chat::render() const
         glPushMatrix();
         glTranslatef(xx, yy, 0.0f);
         glColor3fv(m_colors[i].v);
-        m_font->render(m_players[i] + ": " + m_messages[i]);
+        FrameString line(m_players[i].c_str(), m_players[i].size());
+        line.append(": ").append(m_messages[i].c_str(), m_messages[i].size());
+        m_font->render(line.c_str());
         glPopMatrix();
         
         yy -= m_font->getHeight();
@@ -127,7 +130,8 @@ void Chat::render() const
     // render current
     if (m_active)
     {
-        string render = m_player + ": " + m_message;
+        FrameString render(m_player.c_str(), m_player.size());
+        render.append(": ").append(m_message.c_str(), m_message.size());
         if (fmod(m_timer.read(), 1.0f) > 0.5f)
         {
             render.push_back('_');
@@ -135,7 +139,7 @@ void Chat::render() const
         glPushMatrix();
         glTranslatef(xx, yy, 0.0f);
         glColor3fv(m_color.v);
-        m_font->render(render);
+        m_font->render(render.c_str());
         glPopMatrix();
     }
 
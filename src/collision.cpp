@@ -10,11 +10,12 @@
 #include "geometry.h"
 #include "input.h"
 #include "mesh.h"
+#include "loader.h"
 
 class CollisionConvex : public Collision
 {
 protected:
-    CollisionConvex(const XMLnode& node, const Level* level);
+    CollisionConvex(const XMLelement& node, const Level* level);
     ~CollisionConvex();
     void render() const;
 
@@ -29,7 +30,7 @@ protected:
 class CollisionBox : public CollisionConvex
 {
 public:
-    CollisionBox(const XMLnode& node, const Level* level);
+    CollisionBox(const XMLelement& node, const Level* level);
 
     Vector m_size;      // (1.0f, 1.0f, 1.0f)
 };
@@ -37,7 +38,7 @@ public:
 class CollisionSphere : public CollisionConvex
 {
 public:
-    CollisionSphere(const XMLnode& node, const Level* level);
+    CollisionSphere(const XMLelement& node, const Level* level);
 
     float getRadius() const { return m_radius.x; }
 
@@ -47,7 +48,7 @@ public:
 class CollisionCylinder : public CollisionConvex
 {
 public:
-    CollisionCylinder(const XMLnode& node, const Level* level);
+    CollisionCylinder(const XMLelement& node, const Level* level);
 
     float m_radius;      // 1.0f
     float m_height;      // 1.0f
@@ -56,7 +57,7 @@ public:
 class CollisionCone : public CollisionConvex
 {
 public:
-    CollisionCone(const XMLnode& node, const Level* level);
+    CollisionCone(const XMLelement& node, const Level* level);
 
     float m_radius;      // 1.0f
     float m_height;      // 1.0f
@@ -65,7 +66,7 @@ public:
 class CollisionTree : public Collision
 {
 public:
-    CollisionTree(const XMLnode& node, Level* level);
+    CollisionTree(const XMLelement& node, Level* level);
     ~CollisionTree();
 
     void render() const;
@@ -80,7 +81,7 @@ public:
 class CollisionHMap : public Collision
 {
 public:
-    CollisionHMap(const XMLnode& node, Level* level);
+    CollisionHMap(const XMLelement& node, Level* level);
     ~CollisionHMap();
     
     void render() const;
@@ -103,9 +104,12 @@ private:
     unsigned int m_buffers[4];
 
     vector<Face> m_tmpFaces;
+
+    static void upload(void* hmap); // on main thread
+    void uploadBuffers();
 };
 
-Collision::Collision(const XMLnode& node) :
+Collision::Collision(const XMLelement& node) :
     m_newtonCollision(NULL),
     m_origin(),
     m_inertia(),
@@ -140,7 +144,7 @@ void Collision::create(NewtonCollision* collision, int propertyID, float mass)
     m_origin *= mass;
 }
 
-Collision* Collision::create(const XMLnode& node, Level* level)
+Collision* Collision::create(const XMLelement& node, Level* level)
 {
     string type = node.getAttribute("type");
     
@@ -174,7 +178,7 @@ Collision* Collision::create(const XMLnode& node, Level* level)
     }
 }
 
-CollisionConvex::CollisionConvex(const XMLnode& node, const Level* level) :
+CollisionConvex::CollisionConvex(const XMLelement& node, const Level* level) :
     Collision(node),
     m_material(NULL),
     m_hasOffset(false),
@@ -205,9 +209,9 @@ CollisionConvex::CollisionConvex(const XMLnode& node, const Level* level) :
         m_material = iter->second;;
     }
     
-    for each_const(XMLnodes, node.childs, iter)
+    for each_const(XMLelements, node.childs, iter)
     {
-        const XMLnode& node = *iter;
+        const XMLelement& node = *iter;
         if (node.name == "offset")
         {
             offset = node.getAttributesInVector("xyz");
@@ -248,15 +252,15 @@ void CollisionConvex::render() const
     glPopMatrix();
 }
 
-CollisionBox::CollisionBox(const XMLnode& node, const Level* level) :
+CollisionBox::CollisionBox(const XMLelement& node, const Level* level) :
     CollisionConvex(node, level),
     m_size(1.0f, 1.0f, 1.0f)
 {
     float mass = node.getAttribute<float>("mass");
 
-    for each_const(XMLnodes, node.childs, iter)
+    for each_const(XMLelements, node.childs, iter)
     {
-        const XMLnode& node = *iter;
+        const XMLelement& node = *iter;
         if (node.name == "size")
         {
             m_size = node.getAttributesInVector("xyz");
@@ -279,15 +283,15 @@ CollisionBox::CollisionBox(const XMLnode& node, const Level* level) :
     m_mesh = new CubeMesh(m_size);
 }
 
-CollisionSphere::CollisionSphere(const XMLnode& node, const Level* level) :
+CollisionSphere::CollisionSphere(const XMLelement& node, const Level* level) :
     CollisionConvex(node, level),
     m_radius(1.0f, 1.0f, 1.0f)
 {
     float mass = node.getAttribute<float>("mass");
 
-    for each_const(XMLnodes, node.childs, iter)
+    for each_const(XMLelements, node.childs, iter)
     {
-        const XMLnode& node = *iter;
+        const XMLelement& node = *iter;
         if (node.name == "radius")
         {
             m_radius = node.getAttributesInVector("xyz");
@@ -310,16 +314,16 @@ CollisionSphere::CollisionSphere(const XMLnode& node, const Level* level) :
     m_mesh = new SphereMesh(m_radius, 12, 12);
 }
 
-CollisionCylinder::CollisionCylinder(const XMLnode& node, const Level* level) :
+CollisionCylinder::CollisionCylinder(const XMLelement& node, const Level* level) :
     CollisionConvex(node, level),
     m_radius(1.0f),
     m_height(1.0f)
 {
     float mass = node.getAttribute<float>("mass");
 
-    for each_const(XMLnodes, node.childs, iter)
+    for each_const(XMLelements, node.childs, iter)
     {
-        const XMLnode& node = *iter;
+        const XMLelement& node = *iter;
         if (node.name == "radius")
         {
             m_radius = cast<float>(node.value);
@@ -350,16 +354,16 @@ CollisionCylinder::CollisionCylinder(const XMLnode& node, const Level* level) :
     m_mesh = new CylinderMesh(m_radius, m_height, 4, 12);
 }
 
-CollisionCone::CollisionCone(const XMLnode& node, const Level* level) :
+CollisionCone::CollisionCone(const XMLelement& node, const Level* level) :
     CollisionConvex(node, level),
     m_radius(1.0f),
     m_height(1.0f)
 {
     float mass = node.getAttribute<float>("mass");
 
-    for each_const(XMLnodes, node.childs, iter)
+    for each_const(XMLelements, node.childs, iter)
     {
-        const XMLnode& node = *iter;
+        const XMLelement& node = *iter;
         if (node.name == "radius")
         {
             m_radius = cast<float>(node.value);
@@ -390,88 +394,102 @@ CollisionCone::CollisionCone(const XMLnode& node, const Level* level) :
     m_mesh = new ConeMesh(m_radius, m_height, 4, 12);
 }
 
-CollisionTree::CollisionTree(const XMLnode& node, Level* level) : 
+CollisionTree::CollisionTree(const XMLelement& node, Level* level) : 
     Collision(node), m_first(true), m_list(0)
 {
-    vector<int> props;
+    // faces are added to tree as soon as they are read
+    NewtonCollision* collision = NewtonCreateTreeCollision(World::instance->m_newtonWorld, NULL);
+    NewtonTreeCollisionBeginBuild(collision);
 
-    for each_const(XMLnodes, node.childs, iter)
+    // collision is not owned by anything until create, so it must be
+    // released when level data is invalid
+    try
     {
-        const XMLnode& node = *iter;
-        if (node.name == "face")
+        m_faces.reserve(node.childs.size());
+        m_materials.reserve(node.childs.size());
+
+        for each_const(XMLelements, node.childs, iter)
         {
-            string material = node.getAttribute("material");
-            if (material.empty())
-            {
-                m_materials.push_back(NULL);
-            }
-            else
+            const XMLelement& node = *iter;
+            if (node.name == "face")
             {
-                MaterialsMap::const_iterator iter = level->m_materials.find(material);
-                if (iter == level->m_materials.end())
+                string material = node.getAttribute("material");
+                if (material.empty())
                 {
-                    throw Exception("Couldn't find material '" + material + "'");
+                    m_materials.push_back(NULL);
+                }
+                else
+                {
+                    MaterialsMap::const_iterator iter = level->m_materials.find(material);
+                    if (iter == level->m_materials.end())
+                    {
+                        throw Exception("Couldn't find material '" + material + "'");
+                    }
+                    m_materials.push_back(iter->second);
                 }
-                m_materials.push_back(iter->second);
-            }
             
-            string p = node.getAttribute("property");
-            props.push_back(level->m_properties->getPropertyID(p));
+                string p = node.getAttribute("property");
+                int prop = level->m_properties->getPropertyID(p);
 
-            m_faces.push_back(Face());
-            Face& face = m_faces.back();
+                m_faces.push_back(Face());
+                Face& face = m_faces.back();
+                face.vertexes.reserve(node.childs.size());
+                face.uv.reserve(node.childs.size());
             
-            // needed in grass calculations
+                // needed in grass calculations
 
-            for each_const(XMLnodes, node.childs, iter)
-            {
-                const XMLnode& node = *iter;
-                if (node.name == "vertex")
+                for each_const(XMLelements, node.childs, iter)
                 {
-                    face.vertexes.push_back(node.getAttributesInVector("xyz"));
-                    face.uv.push_back(UV(node.getAttribute<float>("u"), node.getAttribute<float>("v")));
+                    const XMLelement& node = *iter;
+                    if (node.name == "vertex")
+                    {
+                        face.vertexes.push_back(node.getAttributesInVector("xyz"));
+                        face.uv.push_back(UV(node.getAttribute<float>("u"), node.getAttribute<float>("v")));
+                    }
+                    else
+                    { 
+                        throw Exception("Invalid face, unknown node - " + node.name);
+                    }
                 }
-                else
-                { 
-                    throw Exception("Invalid face, unknown node - " + node.name);
+                if (face.uv.size() != 4 && face.uv.size() != 3)
+                {
+                    throw Exception("Face must have 3 or 4 vertexes");
                 }
-            }
-            if (face.uv.size() != 4 && face.uv.size() != 3)
-            {
-                throw Exception("Face must have 3 or 4 vertexes");
-            }
 
-            const Vector& v0 = face.vertexes[0];
-            const Vector& v1 = face.vertexes[1];
-            const Vector& v2 = face.vertexes[2];
+                const Vector& v0 = face.vertexes[0];
+                const Vector& v1 = face.vertexes[1];
+                const Vector& v2 = face.vertexes[2];
             
-            Vector normal = (v1-v0) ^ (v2-v0);
-            normal.norm();
+                Vector normal = (v1-v0) ^ (v2-v0);
+                normal.norm();
 
-            face.normal.resize(face.vertexes.size(), normal);
+                face.normal.resize(face.vertexes.size(), normal);
 
-        }
-        else
-        {
-            throw Exception("Invalid collision, unknown node - " + node.name);
+                NewtonTreeCollisionAddFace(
+                    collision, 
+                    static_cast<int>(face.vertexes.size()), 
+                    face.vertexes[0].v,
+                    sizeof(Vector),
+                    prop);
+
+                // quads are rendered as strips
+                if (face.vertexes.size() == 4)
+                {
+                    std::swap(face.uv[2], face.uv[3]);
+                    std::swap(face.vertexes[2], face.vertexes[3]);
+                }
+            }
+            else
+            {
+                throw Exception("Invalid collision, unknown node - " + node.name);
+            }
         }
     }
-    
-    NewtonCollision* collision = NewtonCreateTreeCollision(World::instance->m_newtonWorld, NULL);
-    NewtonTreeCollisionBeginBuild(collision);
-    for (size_t i=0; i<m_faces.size(); i++)
+    catch (...)
     {
-        int prop = props[i];
-        Face& face = m_faces[i];
-        NewtonTreeCollisionAddFace(
-            collision, 
-            static_cast<int>(face.vertexes.size()), 
-            face.vertexes[0].v,
-            sizeof(Vector),
-            prop);
-        
-        std::swap(face.uv[2], face.uv[3]);
-        std::swap(face.vertexes[2], face.vertexes[3]);
+        NewtonTreeCollisionEndBuild(collision, 0);
+        NewtonReleaseCollision(World::instance->m_newtonWorld, collision);
+        throw;
     }
     NewtonTreeCollisionEndBuild(collision, 0);
     
@@ -526,16 +544,16 @@ CollisionTree::~CollisionTree()
 //    glDeleteBuffersARB(static_cast<GLsizei>(m_faces.size()), &m_buffers[0]);
 }
 
-CollisionHMap::CollisionHMap(const XMLnode& node, Level* level) : Collision(node), m_material(NULL)
+CollisionHMap::CollisionHMap(const XMLelement& node, Level* level) : Collision(node), m_material(NULL)
 {
     string hmap;
     float size = 0.0f;
     string material;
     float repeat = 0.0f;
 
-    for each_const(XMLnodes, node.childs, iter)
+    for each_const(XMLelements, node.childs, iter)
     {
-        const XMLnode& node = *iter;
+        const XMLelement& node = *iter;
         if (node.name == "heightmap")
         {
             hmap = node.getAttribute("name");
@@ -629,19 +647,15 @@ CollisionHMap::CollisionHMap(const XMLnode& node, Level* level) : Collision(node
 #endif
     {
         string filename = "/data/heightmaps/" + hmap + ".tga";
-        File::Reader file(filename);
+        File::Contents file(filename);
         if (!file.is_open())
         {
 
             throw Exception("Heightmap '" + filename + "' not found");
         }
-
-        vector<char> data(file.size());
-        file.read(&data[0], data.size());
-        file.close();
         
         GLFWimage image;
-        if (glfwReadMemoryImage(&data[0], static_cast<int>(data.size()), &image, GLFW_NO_RESCALE_BIT)==GL_FALSE)
+        if (glfwReadMemoryImage(file.data(), static_cast<int>(file.size()), &image, GLFW_NO_RESCALE_BIT)==GL_FALSE)
         {
             throw Exception("Invalid heightmap '" + filename + "' format");
         }
@@ -820,26 +834,36 @@ CollisionHMap::CollisionHMap(const XMLnode& node, Level* level) : Collision(node
     
     if (Video::instance->m_haveVBO)
     {
-        glGenBuffersARB(4, (GLuint*)&m_buffers[0]);
+        Loader::runOnMain(upload, this);
+    }
+}
 
-        glBindBufferARB(GL_ARRAY_BUFFER_ARB, m_buffers[0]);
-        glBufferDataARB(GL_ARRAY_BUFFER_ARB, m_uv.size() * sizeof(UV), &m_uv[0], GL_STATIC_DRAW_ARB);
+void CollisionHMap::upload(void* hmap)
+{
+    static_cast<CollisionHMap*>(hmap)->uploadBuffers();
+}
 
-        glBindBufferARB(GL_ARRAY_BUFFER_ARB, m_buffers[1]);
-        glBufferDataARB(GL_ARRAY_BUFFER_ARB, m_normals.size() * sizeof(Vector), &m_normals[0], GL_STATIC_DRAW_ARB);
+void CollisionHMap::uploadBuffers()
+{
+    glGenBuffersARB(4, (GLuint*)&m_buffers[0]);
 
-        glBindBufferARB(GL_ARRAY_BUFFER_ARB, m_buffers[2]);
-        glBufferDataARB(GL_ARRAY_BUFFER_ARB, m_vertices.size() * sizeof(Vector), &m_vertices[0], GL_STATIC_DRAW_ARB);
+    glBindBufferARB(GL_ARRAY_BUFFER_ARB, m_buffers[0]);
+    glBufferDataARB(GL_ARRAY_BUFFER_ARB, m_uv.size() * sizeof(UV), &m_uv[0], GL_STATIC_DRAW_ARB);
 
-        if (m_indices.size() != 0)
-        {
-            glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB, m_buffers[3]);
-            glBufferDataARB(GL_ELEMENT_ARRAY_BUFFER_ARB, m_indices.size() * sizeof(unsigned short), &m_indices[0], GL_STATIC_DRAW_ARB);
-        }
+    glBindBufferARB(GL_ARRAY_BUFFER_ARB, m_buffers[1]);
+    glBufferDataARB(GL_ARRAY_BUFFER_ARB, m_normals.size() * sizeof(Vector), &m_normals[0], GL_STATIC_DRAW_ARB);
 
-        glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0);
-        glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB, 0);
+    glBindBufferARB(GL_ARRAY_BUFFER_ARB, m_buffers[2]);
+    glBufferDataARB(GL_ARRAY_BUFFER_ARB, m_vertices.size() * sizeof(Vector), &m_vertices[0], GL_STATIC_DRAW_ARB);
+
+    if (m_indices.size() != 0)
+    {
+        glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB, m_buffers[3]);
+        glBufferDataARB(GL_ELEMENT_ARRAY_BUFFER_ARB, m_indices.size() * sizeof(unsigned short), &m_indices[0], GL_STATIC_DRAW_ARB);
     }
+
+    glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0);
+    glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB, 0);
 }
 
 void CollisionHMap::render() const
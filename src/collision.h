@@ -7,7 +7,7 @@
 #include "video.h"
 
 class Body;
-class XMLnode;
+class XMLelement;
 class Level;
 
 class Collision : public NoCopy
@@ -15,7 +15,7 @@ class Collision : public NoCopy
     friend class Body;
 
 public:
-    static Collision* create(const XMLnode& node, Level* level);
+    static Collision* create(const XMLelement& node, Level* level);
     
     virtual void render() const = 0;
     virtual void renderTri(float x, float z) const {}
@@ -27,7 +27,7 @@ public:
     virtual ~Collision();
 
 protected:
-    Collision(const XMLnode& node);
+    Collision(const XMLelement& node);
 
     void create(NewtonCollision* collision);
     void create(NewtonCollision* collision, int propertyID, float mass);
@@ -12,10 +12,6 @@
 #include <iostream>
 #include <algorithm>
 
-#if defined(_DEBUG) && !__MINGW32__ && !__APPLE__ && !__linux__
-#include "mmgr.h"
-#endif
-
 using std::set;
 using std::map; 
 using std::list;
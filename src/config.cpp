@@ -8,7 +8,7 @@ template <class Config> Config* System<Config>::instance = NULL;
 const string Config::CONFIG_FILE = "/config.xml";
 
 const VideoConfig Config::defaultVideo = { 800, 600, true, true, 0, 0, 1, 1, false, 1, 1, true };
-const AudioConfig Config::defaultAudio = { true, 3, 5 };
+const AudioConfig Config::defaultAudio = { true, 3, 5, 64 };
 const MiscConfig Config::defaultMisc = { true, "en", 5.0f, "localhost", "12321", 40.0f };
 
 Config::Config() : m_video(defaultVideo), m_audio(defaultAudio), m_misc(defaultMisc)
@@ -159,6 +159,15 @@ Config::Config() : m_video(defaultVideo), m_audio(defaultAudio), m_misc(defaultM
                     }
                     m_audio.sound_vol = sound_vol;
                 }
+                else if (node.name == "stream_buffer")
+                {
+                    int stream_buffer = cast<int>(node.value);
+                    if (stream_buffer < 4 || stream_buffer > 1024)
+                    {
+                        stream_buffer = 64;
+                    }
+                    m_audio.stream_buffer = stream_buffer;
+                }
                 else
                 {
                     string line = cast<string>(node.line);
@@ -250,6 +259,7 @@ Config::~Config()
     xml.childs.back().childs.push_back(XMLnode("enabled", cast<string>(m_audio.enabled ? 1 : 0)));
     xml.childs.back().childs.push_back(XMLnode("music_vol", cast<string>(m_audio.music_vol)));
     xml.childs.back().childs.push_back(XMLnode("sound_vol", cast<string>(m_audio.sound_vol)));
+    xml.childs.back().childs.push_back(XMLnode("stream_buffer", cast<string>(m_audio.stream_buffer)));
 
     xml.childs.push_back(XMLnode("misc"));
     xml.childs.back().childs.push_back(XMLnode("system_keys", cast<string>(m_misc.system_keys ? 1 : 0)));
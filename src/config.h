@@ -25,6 +25,7 @@ struct AudioConfig
     bool enabled;
     int  music_vol;
     int  sound_vol;
+    int  stream_buffer; // KB
 };
 
 struct MiscConfig
@@ -1,23 +1,237 @@
 #include <stddef.h>
 #include <physfs.h>
 
+#if defined(WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #pragma warning(disable : 4996)
 
 #include <algorithm>
+#include <cstring>
 #include "file.h"
 
 // PRIVATE part
 
 static const size_t BUFSIZE = 4096;
 
+static const unsigned int ZIP_END_SIGNATURE = 0x06054b50;
+static const unsigned int ZIP_CENTRAL_SIGNATURE = 0x02014b50;
+static const unsigned int ZIP_LOCAL_SIGNATURE = 0x04034b50;
+static const size_t ZIP_END_SIZE = 22;
+static const size_t ZIP_CENTRAL_SIZE = 46;
+static const size_t ZIP_LOCAL_SIZE = 30;
+static const size_t ZIP_MAX_COMMENT = 0xFFFF;
+
+static const char PACK_MAGIC[] = "S3DP";
+static const unsigned int PACK_VERSION = 1;
+static const size_t PACK_HEADER_SIZE = 16;
+static const size_t PACK_ENTRY_SIZE = 24;
+static const unsigned int PACK_COMPRESSION_NONE = 0;
+
+typedef pair<size_t, size_t> StoredEntry; // offset, size
+typedef map<string, StoredEntry> StoredEntries;
+
+struct PackEntry
+{
+    unsigned int hash;
+    string       name;
+    size_t       offset;
+    size_t       size;
+
+    bool operator < (const PackEntry& other) const
+    {
+        return hash < other.hash;
+    }
+};
+typedef vector<PackEntry> PackEntries;
+
+static File::Mapping* archive = NULL;
+static string archivePath;
+static StoredEntries storedEntries;
+
+static File::Mapping* pack = NULL;
+static long long packModified = -1;
+static PackEntries packEntries; // sorted by hash
+
+static unsigned int read16(const char* ptr)
+{
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(ptr);
+    return p[0] | (p[1] << 8);
+}
+
+static unsigned int read32(const char* ptr)
+{
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(ptr);
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (p[3] << 24);
+}
+
+// collects all stored entries from zip central directory
+static void indexArchive(const string& path)
+{
+    archive = new File::Mapping(path, true);
+    archivePath = path;
+    if (!archive->is_open() || archive->size() < ZIP_END_SIZE)
+    {
+        clog << "WARNING: can not map '" << path << "', reading through PhysicsFS" << endl;
+        return;
+    }
+
+    const char* data = archive->data();
+    const size_t size = archive->size();
+
+    size_t end = size - ZIP_END_SIZE;
+    const size_t first = size > ZIP_END_SIZE + ZIP_MAX_COMMENT ? size - ZIP_END_SIZE - ZIP_MAX_COMMENT : 0;
+    while (end > first && read32(data + end) != ZIP_END_SIGNATURE)
+    {
+        end--;
+    }
+    if (read32(data + end) != ZIP_END_SIGNATURE)
+    {
+        return;
+    }
+
+    const unsigned int count = read16(data + end + 10);
+    size_t pos = read32(data + end + 16);
+    for (unsigned int i = 0; i < count; i++)
+    {
+        if (pos + ZIP_CENTRAL_SIZE > size || read32(data + pos) != ZIP_CENTRAL_SIGNATURE)
+        {
+            break;
+        }
+
+        const unsigned int flags = read16(data + pos + 8);
+        const unsigned int method = read16(data + pos + 10);
+        const size_t compressed = read32(data + pos + 20);
+        const size_t uncompressed = read32(data + pos + 24);
+        const size_t nameLength = read16(data + pos + 28);
+        const size_t extraLength = read16(data + pos + 30);
+        const size_t commentLength = read16(data + pos + 32);
+        const size_t local = read32(data + pos + 42);
+        const string name(data + pos + ZIP_CENTRAL_SIZE, nameLength);
+        pos += ZIP_CENTRAL_SIZE + nameLength + extraLength + commentLength;
+
+        // no encryption, no compression
+        if ((flags & 1) != 0 || method != 0 || compressed != uncompressed)
+        {
+            continue;
+        }
+        if (local + ZIP_LOCAL_SIZE > size || read32(data + local) != ZIP_LOCAL_SIGNATURE)
+        {
+            continue;
+        }
+
+        // local header can have different extra field than central directory
+        const size_t offset = local + ZIP_LOCAL_SIZE + read16(data + local + 26) + read16(data + local + 28);
+        if (offset + uncompressed <= size)
+        {
+            storedEntries.insert(make_pair("/data/" + name, StoredEntry(offset, uncompressed)));
+        }
+    }
+    clog << "Archive has " << storedEntries.size() << " stored entries." << endl;
+}
+
+// FNV-1a, same as in tools/packData.py
+static unsigned int hashName(const char* name, size_t length)
+{
+    unsigned int hash = 2166136261U;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash = (hash ^ static_cast<unsigned char>(name[i])) * 16777619U;
+    }
+    return hash;
+}
+
+static void indexPack(const string& path)
+{
+    pack = new File::Mapping(path, true);
+    if (!pack->is_open())
+    {
+        return;
+    }
+
+    const char* data = pack->data();
+    const size_t size = pack->size();
+    if (size < PACK_HEADER_SIZE || string(data, 4) != PACK_MAGIC || read32(data + 4) != PACK_VERSION)
+    {
+        clog << "WARNING: invalid data pack '" << path << "', ignoring it" << endl;
+        return;
+    }
+
+    const unsigned int count = read32(data + 8);
+    if (PACK_HEADER_SIZE + count * PACK_ENTRY_SIZE > size)
+    {
+        clog << "WARNING: truncated data pack '" << path << "', ignoring it" << endl;
+        return;
+    }
+
+    packEntries.reserve(count);
+    for (unsigned int i = 0; i < count; i++)
+    {
+        const char* ptr = data + PACK_HEADER_SIZE + i * PACK_ENTRY_SIZE;
+        const size_t nameOffset = read32(ptr + 4);
+        const size_t nameLength = read32(ptr + 8);
+
+        PackEntry entry;
+        entry.hash = read32(ptr + 0);
+        entry.offset = read32(ptr + 12);
+        entry.size = read32(ptr + 16);
+        if (read32(ptr + 20) != PACK_COMPRESSION_NONE
+            || nameOffset + nameLength > size || entry.offset + entry.size > size)
+        {
+            clog << "WARNING: skipping unsupported data pack entry " << i << endl;
+            continue;
+        }
+        entry.name = "/data/" + string(data + nameOffset, nameLength);
+        packEntries.push_back(entry);
+    }
+
+    // packer writes sorted entries, but skipped ones should not break it
+    std::stable_sort(packEntries.begin(), packEntries.end());
+
+    packModified = PHYSFS_getLastModTime("/data.pak");
+    clog << "Data pack has " << packEntries.size() << " files." << endl;
+}
+
+static const PackEntry* findPacked(const string& filename)
+{
+    if (filename.compare(0, 6, "/data/") != 0)
+    {
+        return NULL;
+    }
+
+    PackEntry key;
+    key.hash = hashName(filename.c_str() + 6, filename.size() - 6);
+    PackEntries::const_iterator iter = std::lower_bound(packEntries.begin(), packEntries.end(), key);
+    for (; iter != packEntries.end() && iter->hash == key.hash; iter++)
+    {
+        if (iter->name == filename)
+        {
+            return &*iter;
+        }
+    }
+    return NULL;
+}
+
 namespace File
 {
 
     struct File::_PHYSFS_File : public PHYSFS_File {};
 
-    File::File(_PHYSFS_File* handle) : m_handle(handle)
+    File::File(_PHYSFS_File* handle) : m_handle(handle), m_view(NULL), m_viewSize(0), m_viewPos(0)
     {
-        if (m_handle != NULL && PHYSFS_setBuffer(m_handle, BUFSIZE) == 0)
+        setBuffer(BUFSIZE);
+    }
+
+    void File::setBuffer(size_t size)
+    {
+        if (m_handle != NULL && PHYSFS_setBuffer(m_handle, static_cast<PHYSFS_uint64>(size)) == 0)
         {
             throw Exception(PHYSFS_getLastError());
         }
@@ -39,7 +253,15 @@ namespace File
             pos = static_cast<size_t>(position);
         }
 
-        if (PHYSFS_seek(m_handle, pos) == 0)
+        if (m_view != NULL)
+        {
+            if (pos > m_viewSize)
+            {
+                throw Exception("Seek past end of file");
+            }
+            m_viewPos = pos;
+        }
+        else if (PHYSFS_seek(m_handle, pos) == 0)
         {
             throw Exception(PHYSFS_getLastError());
         }
@@ -47,11 +269,16 @@ namespace File
     
     bool File::is_open()
     {
-        return m_handle != NULL;
+        return m_handle != NULL || m_view != NULL;
     }
 
     size_t File::tell()
     {
+        if (m_view != NULL)
+        {
+            return m_viewPos;
+        }
+
         long long curpos = PHYSFS_tell(m_handle);
 
         if (curpos == -1)
@@ -64,6 +291,11 @@ namespace File
 
     size_t File::size()
     {
+        if (m_view != NULL)
+        {
+            return m_viewSize;
+        }
+
         long long filesize = PHYSFS_fileLength(m_handle);
 
         if (filesize == -1)
@@ -76,6 +308,7 @@ namespace File
 
     void File::close()
     {
+        m_view = NULL;
         if (m_handle == NULL)
         {
             return;
@@ -102,19 +335,33 @@ namespace File
         }
     }
 
-    Reader::Reader(const string& filename) :
-        File(static_cast<_PHYSFS_File*>(PHYSFS_openRead(filename.c_str())))
+    Reader::Reader(const string& filename) : File(NULL)
     {
+        open(filename);
+        setBuffer(BUFSIZE);
     }
 
     void Reader::open(const string& filename)
     {
         close();
+        if (mapView(filename, m_view, m_viewSize))
+        {
+            m_viewPos = 0;
+            return;
+        }
         m_handle = static_cast<_PHYSFS_File*>(PHYSFS_openRead(filename.c_str()));
     }
 
     size_t Reader::read(void* buffer, size_t size)
     {
+        if (m_view != NULL)
+        {
+            size = std::min(size, m_viewSize - m_viewPos);
+            memcpy(buffer, m_view + m_viewPos, size);
+            m_viewPos += size;
+            return size;
+        }
+
         long long result = PHYSFS_read(m_handle, buffer, 1, static_cast<PHYSFS_uint32>(size));
 
         if (result == -1)
@@ -127,6 +374,10 @@ namespace File
 
     bool Reader::eof()
     {
+        if (m_view != NULL)
+        {
+            return m_viewPos >= m_viewSize;
+        }
         return PHYSFS_eof(m_handle) != 0;
     }
 
@@ -149,6 +400,137 @@ namespace File
         return static_cast<size_t>(result);
     }
 
+    Mapping::Mapping(const string& filename, bool systemPath) : m_data(NULL), m_size(0), m_file(NULL), m_mapping(NULL)
+    {
+        string path = filename;
+        if (!systemPath)
+        {
+            const char* realDir = PHYSFS_getRealDir(filename.c_str());
+            if (realDir == NULL)
+            {
+                return;
+            }
+
+            const string ds(PHYSFS_getDirSeparator());
+            for (size_t i = path.find('/'); i != string::npos; i = path.find('/', i + ds.size()))
+            {
+                path.replace(i, 1, ds);
+            }
+            path = realDir + path;
+        }
+
+#if defined(WIN32)
+        HANDLE file = CreateFile(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return;
+        }
+        m_size = static_cast<size_t>(GetFileSize(file, NULL));
+        HANDLE mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping == NULL)
+        {
+            CloseHandle(file);
+            return;
+        }
+        m_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (m_data == NULL)
+        {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return;
+        }
+        m_file = file;
+        m_mapping = mapping;
+#else
+        int file = open(path.c_str(), O_RDONLY);
+        if (file == -1)
+        {
+            return;
+        }
+        struct stat info;
+        if (fstat(file, &info) == 0 && info.st_size > 0)
+        {
+            void* data = mmap(NULL, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+            if (data != MAP_FAILED)
+            {
+                m_data = static_cast<const char*>(data);
+                m_size = static_cast<size_t>(info.st_size);
+            }
+        }
+        ::close(file);
+#endif
+    }
+
+    Mapping::~Mapping()
+    {
+        if (m_data == NULL)
+        {
+            return;
+        }
+#if defined(WIN32)
+        UnmapViewOfFile(m_data);
+        CloseHandle(m_mapping);
+        CloseHandle(m_file);
+#else
+        munmap(const_cast<char*>(m_data), m_size);
+#endif
+    }
+
+    Contents::Contents(const string& filename) : m_data(NULL), m_size(0)
+    {
+        if (mapView(filename, m_data, m_size))
+        {
+            return;
+        }
+
+        Reader file(filename);
+        if (!file.is_open())
+        {
+            return;
+        }
+        m_buffer.resize(file.size());
+        if (!m_buffer.empty())
+        {
+            file.read(&m_buffer[0], m_buffer.size());
+        }
+        file.close();
+
+        // vector data pointer of empty file can be NULL
+        static const char empty = 0;
+        m_data = m_buffer.empty() ? &empty : &m_buffer[0];
+        m_size = m_buffer.size();
+    }
+
+    bool Contents::is_open() const
+    {
+        return m_data != NULL;
+    }
+
+    const char* Contents::data() const
+    {
+        return m_data;
+    }
+
+    size_t Contents::size() const
+    {
+        return m_size;
+    }
+
+    bool Mapping::is_open() const
+    {
+        return m_data != NULL;
+    }
+
+    const char* Mapping::data() const
+    {
+        return m_data;
+    }
+
+    size_t Mapping::size() const
+    {
+        return m_size;
+    }
+
     string getBase(const char* argv0, bool dirSep)
     {
         const string tmp(argv0);
@@ -193,21 +575,38 @@ namespace File
             throw Exception(PHYSFS_getLastError());
         }
 
-        if (PHYSFS_mount((getBase(argv0, true) + "data.zip").c_str(), "/data", 1) == 0)
+        // data.zip is optional when data.pak is present
+        const string zip = getBase(argv0, true) + "data.zip";
+        const bool zipMounted = PHYSFS_mount(zip.c_str(), "/data", 1) != 0;
+        if (zipMounted)
         {
-            throw Exception(PHYSFS_getLastError());
+            indexArchive(zip);
         }
 
         if (PHYSFS_mount(getBase(argv0).c_str(), "/", 0) == 0)
         {
             throw Exception(PHYSFS_getLastError());
         }
+
+        indexPack(getBase(argv0, true) + "data.pak");
+        if (!zipMounted && packEntries.empty())
+        {
+            throw Exception("Neither data.zip nor data.pak found");
+        }
     }
 
     void done()
     {
         clog << "Closing filesystem." << endl;
 
+        storedEntries.clear();
+        delete archive;
+        archive = NULL;
+
+        packEntries.clear();
+        delete pack;
+        pack = NULL;
+
         if (PHYSFS_deinit()==0)
         {
             clog << "ERROR: " << Exception(PHYSFS_getLastError()) << endl;
@@ -216,7 +615,101 @@ namespace File
 
     bool exists(const string& filename)
     {
-        return PHYSFS_exists(filename.c_str()) != 0;
+        return PHYSFS_exists(filename.c_str()) != 0 || findPacked(filename) != NULL;
+    }
+
+    StringVector enumerate(const string& dirname)
+    {
+        StringVector result;
+
+        char** files = PHYSFS_enumerateFiles(dirname.c_str());
+        if (files != NULL)
+        {
+            for (char** i = files; *i != NULL; i++)
+            {
+                result.push_back(*i);
+            }
+            PHYSFS_freeList(files);
+        }
+
+        const string prefix = (!dirname.empty() && dirname[dirname.size()-1] == '/') ? dirname : dirname + "/";
+        for each_const(PackEntries, packEntries, iter)
+        {
+            const string& name = iter->name;
+            if (name.size() > prefix.size()
+                && name.compare(0, prefix.size(), prefix) == 0
+                && name.find('/', prefix.size()) == string::npos)
+            {
+                result.push_back(name.substr(prefix.size()));
+            }
+        }
+
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+        return result;
+    }
+
+    long long modified(const string& filename)
+    {
+        long long time = PHYSFS_getLastModTime(filename.c_str());
+        if (time == -1 && findPacked(filename) != NULL)
+        {
+            return packModified;
+        }
+        return time;
+    }
+
+    bool mapStored(const string& filename, const char*& data, size_t& size)
+    {
+        if (archive == NULL || !archive->is_open())
+        {
+            return false;
+        }
+
+        // file could be overridden by real file in base directory
+        const char* realDir = PHYSFS_getRealDir(filename.c_str());
+        if (realDir == NULL || archivePath != realDir)
+        {
+            return false;
+        }
+
+        StoredEntries::const_iterator iter = storedEntries.find(filename);
+        if (iter == storedEntries.end())
+        {
+            return false;
+        }
+
+        data = archive->data() + iter->second.first;
+        size = iter->second.second;
+        return true;
+    }
+
+    bool mapView(const string& filename, const char*& data, size_t& size)
+    {
+        // real files in base directory override packed ones
+        const char* realDir = PHYSFS_getRealDir(filename.c_str());
+        if (realDir != NULL && archivePath != realDir)
+        {
+            return false;
+        }
+
+        const PackEntry* entry = findPacked(filename);
+        if (entry != NULL)
+        {
+            data = pack->data() + entry->offset;
+            size = entry->size;
+            return true;
+        }
+
+        return mapStored(filename, data, size);
+    }
+
+    void makeDir(const string& dirname)
+    {
+        if (PHYSFS_mkdir(dirname.c_str()) == 0)
+        {
+            throw Exception(PHYSFS_getLastError());
+        }
     }
 
 }
@@ -12,6 +12,19 @@ namespace File
     void init(const char* argv0);
     void done();
     bool exists(const string& filename);
+    long long modified(const string& filename); // -1 if unknown
+    void makeDir(const string& dirname);
+
+    // names of files directly inside directory, from PhysicsFS and data.pak
+    StringVector enumerate(const string& dirname);
+
+    // points to uncompressed (stored) entry inside memory mapped data.zip,
+    // returns false if file is not inside archive or is compressed
+    bool mapStored(const string& filename, const char*& data, size_t& size);
+
+    // points to file inside memory mapped data.pak (or stored data.zip entry),
+    // returns false if file is overridden by real file or is not packed
+    bool mapView(const string& filename, const char*& data, size_t& size);
 
     class File : public NoCopy
     {
@@ -22,11 +35,17 @@ namespace File
         size_t tell();
         size_t size();
         void close();
+        void setBuffer(size_t size);
 
     protected:
         struct _PHYSFS_File;
         _PHYSFS_File* m_handle;
 
+        // reading from mapView instead of PhysicsFS
+        const char* m_view;
+        size_t      m_viewSize;
+        size_t      m_viewPos;
+
         File(_PHYSFS_File* handle);
     };
 
@@ -48,6 +67,41 @@ namespace File
         size_t write(const void* buffer, size_t size);
     };
 
+    // whole file contents, without copying if file is memory mapped
+    class Contents : public NoCopy
+    {
+    public:
+        Contents(const string& filename);
+
+        bool is_open() const;
+        const char* data() const;
+        size_t size() const;
+
+    private:
+        const char*  m_data;
+        size_t       m_size;
+        vector<char> m_buffer;
+    };
+
+    // read only memory mapping of whole file, works only
+    // for real files, not for files inside archives
+    class Mapping : public NoCopy
+    {
+    public:
+        Mapping(const string& filename, bool systemPath = false);
+        ~Mapping();
+
+        bool is_open() const;
+        const char* data() const;
+        size_t size() const;
+
+    private:
+        const char* m_data;
+        size_t      m_size;
+        void*       m_file;    // win32 only
+        void*       m_mapping; // win32 only
+    };
+
 };
 
 #endif
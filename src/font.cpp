@@ -1,20 +1,41 @@
-#include <GL/glfw.h>
+#include "video.h"
 #include "font.h"
 #include "file.h"
 #include "vmath.h"
+#include "loader.h"
+#include "memory_budget.h"
 
 typedef map<string, const Font*> FontMap;
 
 FontMap fonts;
 
+// layouts of this many recently used strings are kept per font
+static const size_t MAX_LAYOUTS = 256;
+
+struct FontLoad
+{
+    const string* name;
+    const Font*   font;
+};
+
 const Font* Font::get(const string& name)
 {
-    FontMap::const_iterator iter = fonts.find(name);
+    FontLoad load = { &name, NULL };
+    Loader::runOnMain(Font::load, &load);
+    return load.font;
+}
+
+void Font::load(void* arg)
+{
+    FontLoad* load = static_cast<FontLoad*>(arg);
+
+    FontMap::const_iterator iter = fonts.find(*load->name);
     if (iter != fonts.end())
     {
-        return iter->second;
+        load->font = iter->second;
+        return;
     }
-    return fonts.insert(make_pair(name, new Font(name))).first->second;
+    load->font = fonts.insert(make_pair(*load->name, new Font(*load->name))).first->second;
 }
 
 void Font::unload()
@@ -53,7 +74,7 @@ struct Char
 };
 #pragma pack ( pop )
 
-Font::Font(const string& filename) : m_texture(0)
+Font::Font(const string& filename) : m_texture(0), m_memory(0)
 {
     clog << "Loading font '" << filename << "'..." << endl;
 
@@ -95,21 +116,17 @@ Font::Font(const string& filename) : m_texture(0)
 #endif
 
     // loading texture
-    File::Reader file("/data/font/" + filename + "_00.tga");
+    File::Contents file("/data/font/" + filename + "_00.tga");
     if (!file.is_open())
     {
         throw Exception("Font texture '" + filename + "_00.tga' not found");
     }
-    size_t filesize = file.size();
-    vector<char> data(filesize);
-    file.read(&data[0], filesize);
-    file.close();
 
     glGenTextures(1, (GLuint*)&m_texture);
     glBindTexture(GL_TEXTURE_2D, m_texture);
 
     GLFWimage image;
-    glfwReadMemoryImage(&data[0], static_cast<int>(filesize), &image, GLFW_NO_RESCALE_BIT);
+    glfwReadMemoryImage(file.data(), static_cast<int>(file.size()), &image, GLFW_NO_RESCALE_BIT);
     if (image.BytesPerPixel == 1)
     {
         glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, image.Width, image.Height, 0, GL_ALPHA, GL_UNSIGNED_BYTE, image.Data);
@@ -123,6 +140,9 @@ Font::Font(const string& filename) : m_texture(0)
         assert(false);
     }
 
+    m_memory = image.Width * image.Height * image.BytesPerPixel;
+    MemoryBudget::add(MemoryBudget::UI, m_memory);
+
     glfwFreeImage(&image);
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -130,8 +150,8 @@ Font::Font(const string& filename) : m_texture(0)
 
     
     
-    m_listbase = glGenLists(m_count);
     m_widths.resize(m_count, -1);
+    m_glyphs.resize(m_count);
 
     int idx = 0;
     int pos = 0;
@@ -139,42 +159,32 @@ Font::Font(const string& filename) : m_texture(0)
     {
         while (idx != chars[pos].id)
         {
-            m_widths[idx] = head.size;
-            glNewList(m_listbase + idx++, GL_COMPILE);
-            glTranslatef(head.size, 0.0f, 0.0f);
-            glEndList();
+            // missing characters are empty space
+            Glyph& g = m_glyphs[idx];
+            g.u1 = g.v1 = g.u2 = g.v2 = 0.0f;
+            g.x1 = g.y1 = g.x2 = g.y2 = 0.0f;
+            m_widths[idx++] = head.size;
         }
         
         const Char& c = chars[pos++];
         m_widths[idx] = c.xadvance; // - c.xoffset;
-        glNewList(m_listbase + idx++, GL_COMPILE);
 
-        float u1 = static_cast<float>(c.x) / static_cast<float>(head.texW);
-        float v1 = 1.0f - static_cast<float>(c.y) / head.texH;
-        float u2 = static_cast<float>(c.x + c.width) / static_cast<float>(head.texW);
-        float v2 = 1.0f - static_cast<float>(c.y + c.height) / head.texH;
+        Glyph& g = m_glyphs[idx++];
+        g.u1 = static_cast<float>(c.x) / static_cast<float>(head.texW);
+        g.v1 = 1.0f - static_cast<float>(c.y) / head.texH;
+        g.u2 = static_cast<float>(c.x + c.width) / static_cast<float>(head.texW);
+        g.v2 = 1.0f - static_cast<float>(c.y + c.height) / head.texH;
 
-        float x1 = static_cast<float>(c.xoffset);
-        float y1 = static_cast<float>(m_height - c.yoffset);
-        float x2 = static_cast<float>(c.xoffset + c.width);
-        float y2 = static_cast<float>(m_height - (c.yoffset + c.height));
-        
-        glBegin(GL_TRIANGLE_STRIP);
-            glTexCoord2f(u1, v1); glVertex2f(x1, y1);
-            glTexCoord2f(u1, v2); glVertex2f(x1, y2);
-            glTexCoord2f(u2, v1); glVertex2f(x2, y1);
-            glTexCoord2f(u2, v2); glVertex2f(x2, y2);
-        glEnd();
-  
-        glTranslatef(static_cast<float>(c.xadvance), 0.0f, 0.0f); //  - c.xoffset
-
-        glEndList();
+        g.x1 = static_cast<float>(c.xoffset);
+        g.y1 = static_cast<float>(m_height - c.yoffset);
+        g.x2 = static_cast<float>(c.xoffset + c.width);
+        g.y2 = static_cast<float>(m_height - (c.yoffset + c.height));
     }
 }
 
 Font::~Font()
 {
-    glDeleteLists(m_listbase, m_count);
+    MemoryBudget::remove(MemoryBudget::UI, m_memory);
     glDeleteTextures(1, (GLuint*)&m_texture);
 }
 
@@ -212,8 +222,6 @@ void Font::begin(bool shadowed, const Vector& shadow, float shadowWidth) const
     glDepthMask(GL_FALSE);
     glDisable(GL_CULL_FACE);
 
-    //glListBase(m_listbase);
-
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
@@ -226,7 +234,6 @@ void Font::begin(bool shadowed, const Vector& shadow, float shadowWidth) const
 
 void Font::begin2() const
 {
-    glListBase(m_listbase);
     glBindTexture(GL_TEXTURE_2D, m_texture);
 }
 
@@ -300,82 +307,160 @@ inline unsigned int nextUTF8char(const char* & x)
   }                                                    \
 }
 */
-void Font::renderPlain(const string& text) const
+const TextLayout& Font::getLayout(const string& text) const
 {
-    glPushMatrix();
-    const char* x = text.c_str();
+    TextLayoutMap::iterator iter = m_layouts.find(text);
+    if (iter != m_layouts.end())
+    {
+        m_layoutOrder.splice(m_layoutOrder.begin(), m_layoutOrder, iter->second.order);
+        return iter->second.layout;
+    }
+
+    if (m_layouts.size() >= MAX_LAYOUTS)
+    {
+        m_layouts.erase(m_layoutOrder.back());
+        m_layoutOrder.pop_back();
+    }
+    CachedLayout& cached = m_layouts[text];
+    cached.order = m_layoutOrder.insert(m_layoutOrder.begin(), text);
+
+    TextLayout& layout = cached.layout;
+    layout.width = 0;
 
-    while (unsigned int c = nextUTF8char(x))
+    float x = 0.0f;
+    const char* ptr = text.c_str();
+    while (true)
     {
+        unsigned int c = nextUTF8char(ptr);
+        if (c == '\n' || c == 0)
+        {
+            layout.lineEnds.push_back(layout.quads.size());
+            layout.lineWidths.push_back(static_cast<int>(x));
+            layout.width = std::max(layout.width, layout.lineWidths.back());
+            x = 0.0f;
+            if (c == 0)
+            {
+                break;
+            }
+            continue;
+        }
+
         if (c < static_cast<unsigned int>(m_widths.size()) && m_widths[c] != -1)
         {
-            glCallList(m_listbase + c);
+            const Glyph& g = m_glyphs[c];
+            if (g.x1 != g.x2)
+            {
+                Glyph q = g;
+                q.x1 += x;
+                q.x2 += x;
+                layout.quads.push_back(q);
+            }
+            x += static_cast<float>(m_widths[c]);
         }
     }
-//        glCallLists(static_cast<unsigned int>(text.size()), GL_UNSIGNED_SHORT, text.c_str());
 
-    glPopMatrix();
+    layout.height = m_height * static_cast<int>(layout.lineEnds.size());
+
+    return layout;
 }
 
-void Font::render(const string& text, AlignType align) const
+const TextLayout& Font::getLayout(const char* text) const
 {
-    Vector shadowColor(m_shadow);
-    Vector forAlpha;
-    glGetFloatv(GL_CURRENT_COLOR, forAlpha.v);
-    shadowColor.w = forAlpha.w;
-    //
-
-    size_t pos, begin = 0;
-    string line;
-    float linePos = 0.0f;
-    int width;
-    while (begin < text.size())
+    // key keeps its capacity, so only new texts allocate
+    m_key.assign(text);
+    return getLayout(m_key);
+}
+
+void Font::addQuads(const TextLayout& layout, size_t begin, size_t end, float x, float y, 
+                    const Matrix& transform, const unsigned char color[4]) const
+{
+    if (begin == end)
     {
-        pos = text.find('\n', begin);
-        if (pos == string::npos)
+        return;
+    }
+
+    UIVertex* v = Video::instance->addUIVertices(m_texture, 6 * (end - begin));
+    for (size_t i = begin; i < end; i++)
+    {
+        const Glyph& q = layout.quads[i];
+
+        // two triangles per glyph
+        const float corners[6][4] = {
+            { q.u1, q.v1, q.x1, q.y1 },
+            { q.u1, q.v2, q.x1, q.y2 },
+            { q.u2, q.v1, q.x2, q.y1 },
+            { q.u2, q.v1, q.x2, q.y1 },
+            { q.u1, q.v2, q.x1, q.y2 },
+            { q.u2, q.v2, q.x2, q.y2 },
+        };
+
+        for (int k = 0; k < 6; k++, v++)
         {
-            pos = text.size();
+            const Vector p = transform * Vector(corners[k][2] + x, corners[k][3] + y, 0.0f);
+            v->u = corners[k][0];
+            v->v = corners[k][1];
+            std::copy(color, color + 4, v->color);
+            v->x = p.x;
+            v->y = p.y;
+            v->z = 0.0f;
         }
+    }
+}
+
+void Font::render(const string& text, AlignType align) const
+{
+    render(getLayout(text), align);
+}
+
+void Font::render(const char* text, AlignType align) const
+{
+    render(getLayout(text), align);
+}
 
-        line = text.substr(begin, pos - begin);
+void Font::render(const TextLayout& layout, AlignType align) const
+{
+    Matrix transform;
+    unsigned char color[4];
+    Video::instance->getUIState(transform, color);
 
-        begin = pos + 1;
+    unsigned char shadowColor[4];
+    for (int i = 0; i < 3; i++)
+    {
+        shadowColor[i] = static_cast<unsigned char>(std::min(std::max(m_shadow.v[i], 0.0f), 1.0f) * 255.0f + 0.5f);
+    }
+    shadowColor[3] = color[3];
 
-        glPushMatrix();
+    size_t begin = 0;
+    float linePos = 0.0f;
+    for (size_t i = 0; i < layout.lineEnds.size(); i++)
+    {
+        const size_t end = layout.lineEnds[i];
+        const int width = layout.lineWidths[i];
 
+        float x = 0.0f;
         switch (align)
         {
         case Align_Left:
             break;
         case Align_Center:
-            width = getWidth(line);
-            glTranslatef(static_cast<float>(-width/2), 0.0f, 0.0f);
+            x = static_cast<float>(-width/2);
             break;
         case Align_Right:
-            width = getWidth(line);
-            glTranslatef(static_cast<float>(-width), 0.0f, 0.0f);
+            x = static_cast<float>(-width);
             break;
         default:
             assert(false);
         };
-        glTranslatef(0.0f, linePos, 0.0f);       
 
         if (m_shadowed)
         {
-            glPushAttrib(GL_CURRENT_BIT);
-            glPushMatrix();
-                glColor4fv(shadowColor.v);
-                glTranslatef(m_shadowWidth, - m_shadowWidth, 0.0f);
-                renderPlain(line);
-            glPopMatrix();
-            glPopAttrib();
+            addQuads(layout, begin, end, x + m_shadowWidth, linePos - m_shadowWidth, transform, shadowColor);
         }
+        addQuads(layout, begin, end, x, linePos, transform, color);
 
-        renderPlain(line);
-        glPopMatrix();
+        begin = end;
         linePos -= m_height;
     }
-
 }
 
 void Font::end() const
@@ -390,34 +475,7 @@ void Font::end() const
 
 int Font::getWidth(const string& text) const
 {
-    int maxWidth = 0;
-    int width = 0;
-    const char* x = text.c_str();
-    while (unsigned int c = nextUTF8char(x))
-    {
-        if (c < static_cast<unsigned int>(m_widths.size()) && m_widths[c] != -1)
-        {
-            if (c == '\n')
-            {
-                if (width > maxWidth)
-                {
-                    maxWidth = width;
-                }
-                width = 0;
-            }
-            width += m_widths[c];
-        }
-    }
-    if (width > maxWidth)
-    {
-        maxWidth = width;
-    }
-    return maxWidth;
-}
-
-bool isEndline(const char& t)
-{
-    return t == '\n';
+    return getLayout(text).width;
 }
 
 int Font::getHeight() const
@@ -427,5 +485,5 @@ int Font::getHeight() const
 
 int Font::getHeight(const string& text) const
 {
-    return static_cast<int>(m_height * (1 + std::count_if(text.begin(), text.end(), isEndline)));
+    return getLayout(text).height;
 }
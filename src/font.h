@@ -4,6 +4,33 @@
 #include "common.h"
 #include "vmath.h"
 
+struct Glyph
+{
+    float u1, v1, u2, v2;
+    float x1, y1, x2, y2;
+};
+
+// glyph quads of one text, lines are ranges of quads
+struct TextLayout
+{
+    int            width;
+    int            height;
+    vector<Glyph>  quads;
+    vector<size_t> lineEnds;
+    IntVector      lineWidths;
+};
+
+typedef list<string> TextLayoutOrder;
+
+struct CachedLayout
+{
+    TextLayout                layout;
+    TextLayoutOrder::iterator order;
+};
+
+typedef vector<Glyph> GlyphVector;
+typedef map<string, CachedLayout> TextLayoutMap;
+
 class Font : public NoCopy
 {
 public:
@@ -24,6 +51,13 @@ public:
 
     void begin(bool shadowed = true, const Vector& shadow = Vector(0.1f, 0.1f, 0.1f), float shadowWidth = 1.5f) const;
     void render(const string& text, AlignType align = Align_Left) const;
+    void render(const char* text, AlignType align = Align_Left) const;
+    void render(const TextLayout& layout, AlignType align = Align_Left) const;
+
+    // least recently used layouts are dropped from cache
+    const TextLayout& getLayout(const string& text) const;
+    // for text in frame memory, looking up cached layout does not allocate
+    const TextLayout& getLayout(const char* text) const;
     void end() const;
 
     void begin2() const;
@@ -32,18 +66,26 @@ private:
     Font(const string& filename);
     ~Font();
 
-    unsigned int m_listbase;
+    static void load(void* arg); // on main thread
+
     unsigned int m_texture;
+    size_t       m_memory;
+
+    int         m_count;
+    int         m_height;
+    IntVector   m_widths;
+    GlyphVector m_glyphs;
 
-    int       m_count;
-    int       m_height;
-    IntVector m_widths;
+    mutable TextLayoutMap   m_layouts;
+    mutable string          m_key;
+    mutable TextLayoutOrder m_layoutOrder;
     
     mutable Vector    m_shadow;
     mutable bool      m_shadowed;
     mutable float     m_shadowWidth;
     
-    void renderPlain(const string& text) const;
+    void addQuads(const TextLayout& layout, size_t begin, size_t end, float x, float y, 
+                  const Matrix& transform, const unsigned char color[4]) const;
 };
 
 #endif
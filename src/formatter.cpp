@@ -1,15 +1,40 @@
+#include <cstdio>
+
 #include "formatter.h"
 
 Formatter::Formatter(const string& txt) : m_txt(txt)
 {
 }
+
+Formatter& Formatter::operator () (int value)
+{
+    char buffer[16];
+    int length = std::sprintf(buffer, "%d", value);
+    updateFirst(buffer, length);
+    return *this;
+}
+
+Formatter& Formatter::operator () (float value)
+{
+    // same as default stream formatting
+    char buffer[32];
+    int length = std::sprintf(buffer, "%g", value);
+    updateFirst(buffer, length);
+    return *this;
+}
+
+Formatter& Formatter::operator () (const string& value)
+{
+    updateFirst(value.c_str(), value.size());
+    return *this;
+}
    
 Formatter::operator string ()
 {
     return m_txt;
 }
 
-void Formatter::updateFirst(const string& value)
+void Formatter::updateFirst(const char* value, size_t length)
 {
     size_t offset = 0;
     size_t pos = m_txt.find('$');
@@ -29,8 +54,8 @@ void Formatter::updateFirst(const string& value)
             int num = m_txt[pos+1] - '0';
             if (num == 1)
             {
-                m_txt = m_txt.substr(0, pos) + value + m_txt.substr(pos+2, m_txt.size());
-                offset = pos + value.size();
+                m_txt.replace(pos, 2, value, length);
+                offset = pos + length;
             }
             else
             {
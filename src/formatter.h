@@ -11,18 +11,24 @@ public:
     template <typename T>
     inline Formatter& operator () (T value);
 
+    // common arguments are formatted without stringstream
+    Formatter& operator () (int value);
+    Formatter& operator () (float value);
+    Formatter& operator () (const string& value);
+
     operator string ();
 
 private:
     string m_txt;
 
-    void updateFirst(const string& value);
+    void updateFirst(const char* value, size_t length);
 };
 
 template <typename T>
 Formatter& Formatter::operator () (T value)
 {
-    updateFirst(cast<string>(value));
+    const string str = cast<string>(value);
+    updateFirst(str.c_str(), str.size());
     return *this;
 }
 
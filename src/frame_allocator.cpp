@@ -0,0 +1,24 @@
+#include "frame_allocator.h"
+#include "arena.h"
+
+// enough for few packets and text lines, more blocks are added if needed
+static const size_t FRAME_BLOCK = 64 * 1024;
+
+static Arena arena(FRAME_BLOCK);
+static size_t lastUsed = 0;
+
+void* FrameAllocator::allocate(size_t size)
+{
+    return arena.allocate(size);
+}
+
+void FrameAllocator::reset()
+{
+    lastUsed = arena.used();
+    arena.reset();
+}
+
+size_t FrameAllocator::lastFrameUsed()
+{
+    return lastUsed;
+}
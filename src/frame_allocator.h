@@ -0,0 +1,80 @@
+#ifndef __FRAME_ALLOCATOR_H__
+#define __FRAME_ALLOCATOR_H__
+
+#include <new>
+#include <limits>
+#include <cstddef>
+
+#include "common.h"
+
+// bump allocator for temporaries of main thread that are not needed
+// after current frame, Game::run resets it at end of every frame;
+// after first frames its blocks are reused and heap is not touched
+class FrameAllocator
+{
+public:
+    static void* allocate(size_t size);
+    static void reset();
+
+    static size_t lastFrameUsed(); // bytes used by frame before last reset
+};
+
+// STL allocator from frame memory, deallocate does nothing,
+// containers using it must not live longer than frame
+template <typename T>
+class FrameAlloc
+{
+public:
+    typedef T              value_type;
+    typedef T*             pointer;
+    typedef const T*       const_pointer;
+    typedef T&             reference;
+    typedef const T&       const_reference;
+    typedef size_t         size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef FrameAlloc<U> other;
+    };
+
+    FrameAlloc() {}
+    FrameAlloc(const FrameAlloc&) {}
+    template <typename U>
+    FrameAlloc(const FrameAlloc<U>&) {}
+
+    pointer address(reference x) const { return &x; }
+    const_pointer address(const_reference x) const { return &x; }
+
+    pointer allocate(size_type n, const void* = 0)
+    {
+        return static_cast<pointer>(FrameAllocator::allocate(n * sizeof(T)));
+    }
+
+    void deallocate(pointer, size_type) {}
+
+    size_type max_size() const
+    {
+        return std::numeric_limits<size_type>::max() / sizeof(T);
+    }
+
+    void construct(pointer p, const T& value) { new (p) T(value); }
+    void destroy(pointer p) { p->~T(); }
+};
+
+template <typename T, typename U>
+inline bool operator == (const FrameAlloc<T>&, const FrameAlloc<U>&)
+{
+    return true;
+}
+
+template <typename T, typename U>
+inline bool operator != (const FrameAlloc<T>&, const FrameAlloc<U>&)
+{
+    return false;
+}
+
+typedef std::basic_string<char, std::char_traits<char>, FrameAlloc<char> > FrameString;
+
+#endif
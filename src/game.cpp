@@ -19,11 +19,18 @@
 #include "colors.h"
 #include "xml.h"
 #include "random.h"
+#include "simulation.h"
+#include "loading.h"
+#include "profiler.h"
+#include "benchmark.h"
+#include "frame_allocator.h"
 
 template <class Game> Game* System<Game>::instance = NULL;
 
 static const string USER_PROFILE_FILE = "/user.xml";
 
+static const int TRACE_FRAMES = 300;
+
 static const unsigned int M1 = 0x0BADC0DE;
 static const unsigned int M2 = 0xDEADBEEF;
 
@@ -36,7 +43,9 @@ Game::Game() :
     m_current(0),
     m_userProfile(NULL),
     m_state(NULL),
-    m_screenLast(false)
+    m_screenLast(false),
+    m_profilerLast(false),
+    m_traceLast(false)
 {
     // these and only these objects are singletons,
     // they all have public static instance attribute
@@ -52,6 +61,12 @@ Game::Game() :
     loadUserData();
     loadCpuData();
 
+    if (g_simulateMatches > 0 || g_benchmarkSeconds > 0.0f)
+    {
+        // Simulation and Benchmark replace states
+        return;
+    }
+
     if (g_needsToReload)
     {
         g_needsToReload = false;
@@ -147,6 +162,18 @@ void Game::run()
 
     m_video->init();
 
+    if (g_simulateMatches > 0)
+    {
+        Simulation(g_simulateMatches).run();
+        return;
+    }
+
+    if (g_benchmarkSeconds > 0.0f)
+    {
+        m_state = new Benchmark(m_userProfile, g_benchmarkSeconds);
+        m_state->init();
+    }
+
     bool running = true;
     bool previous_active = true;
     
@@ -160,11 +187,24 @@ void Game::run()
 
     while (running)
     {
-        m_audio->update();
-        m_input->update();
-        m_network->update();
+        Profiler::frame();
 
-        m_state->control();
+        {
+            ProfileZone zone("Audio::update");
+            m_audio->update();
+        }
+        {
+            ProfileZone zone("Input::update");
+            m_input->update();
+        }
+        {
+            ProfileZone zone("Network::update");
+            m_network->update();
+        }
+        {
+            ProfileZone zone("State::control");
+            m_state->control();
+        }
 
         float newTime = timer.read();
         float deltaTime = newTime - currentTime;
@@ -176,21 +216,34 @@ void Game::run()
         {
             accum += deltaTime;
 
-            m_state->update(accum - fmodf(accum, DT));
+            {
+                ProfileZone zone("State::update");
+                m_state->update(accum - fmodf(accum, DT));
+            }
 
             while (accum >= DT)
             {
+                ProfileZone zone("State::updateStep");
                 m_state->updateStep(DT);
                 accum -= DT;
             }
         }
         else
         {
-            m_state->update(deltaTime);
-            m_state->updateStep(deltaTime);
+            {
+                ProfileZone zone("State::update");
+                m_state->update(deltaTime);
+            }
+            {
+                ProfileZone zone("State::updateStep");
+                m_state->updateStep(deltaTime);
+            }
         }
 
-        m_state->prepare();
+        {
+            ProfileZone zone("State::prepare");
+            m_state->prepare();
+        }
 
 #ifndef NDEBUG
         if (Input::instance->key('`'))
@@ -203,15 +256,26 @@ void Game::run()
             glPolygonMode(GL_FRONT, GL_FILL);
         }
 #endif
-        m_state->render();
+        {
+            ProfileZone zone("State::render");
+            m_state->render();
+        }
         
         fps.update();
 
-        if (Config::instance->m_video.show_fps)
         {
-            fps.render();
+            ProfileZone zone("UI");
+            if (Config::instance->m_video.show_fps)
+            {
+                fps.render();
+            }
+            Profiler::render(static_cast<float>(m_video->getResolution().second - 3 * font->getHeight() - 5));
+            m_video->flushUI();
+        }
+        {
+            ProfileZone zone("SwapBuffers");
+            glfwSwapBuffers();
         }
-        glfwSwapBuffers();
 
         if (Input::instance->key(GLFW_KEY_F12) && m_screenLast==false)
         {
@@ -223,6 +287,24 @@ void Game::run()
             m_screenLast = false;
         }
 
+        // F10 toggles profiler overlay, F11 writes trace of next frames
+        if (Input::instance->key(GLFW_KEY_F10) != m_profilerLast)
+        {
+            m_profilerLast = !m_profilerLast;
+            if (m_profilerLast)
+            {
+                Profiler::setVisible(!Profiler::isVisible());
+            }
+        }
+        if (Input::instance->key(GLFW_KEY_F11) != m_traceLast)
+        {
+            m_traceLast = !m_traceLast;
+            if (m_traceLast)
+            {
+                Profiler::capture(TRACE_FRAMES);
+            }
+        }
+
         State::Type newState = m_state->progress();
 
         if (newState == State::Quit)
@@ -231,9 +313,17 @@ void Game::run()
         }
         else if (newState != State::Current)
         {
+            State* next = m_state->next();
             delete m_state;
-            m_state = switchState(newState);
-            m_state->init();
+            if (next != NULL)
+            {
+                m_state = next;
+            }
+            else
+            {
+                m_state = switchState(newState);
+                m_state->init();
+            }
 
             timer.reset();
             fps.reset();
@@ -256,6 +346,8 @@ void Game::run()
             running = false;
         }
 
+        // temporaries of this frame are not used anymore
+        FrameAllocator::reset();
     }
 
     /*
@@ -287,6 +379,7 @@ State* Game::switchState(const State::Type nextState)
         m_fixedTimestep = false;
         return new Intro();
     case State::Menu  : return new Menu(m_userProfile, m_unlockable, m_current);
+    case State::Loading : return new Loading(new World(m_userProfile, m_unlockable, m_current));
     case State::World : return new World(m_userProfile, m_unlockable, m_current);
     default:
         assert(false);
@@ -50,6 +50,8 @@ private:
     int         m_unlockable;
     int         m_current;
     bool        m_screenLast;
+    bool        m_profilerLast;
+    bool        m_traceLast;
 
     State* switchState(const State::Type newState);
     void loadCpuData();
@@ -5,8 +5,11 @@
 #include "random.h"
 #include "geometry.h"
 #include "config.h"
+#include "loader.h"
+#include "profiler.h"
+#include "memory_budget.h"
 
-Grass::Grass(const Level* level) : m_time(0.0f), m_count(0), m_grassTex(NULL)
+Grass::Grass(const Level* level) : m_time(0.0f), m_count(0), m_grassTex(NULL), m_memory(0)
 {
     // 1.0f, 2.0f, 4.0f
     float grass_density = static_cast<float>(1 << Config::instance->m_video.grass_density) / 2.0f;
@@ -72,25 +75,37 @@ Grass::Grass(const Level* level) : m_time(0.0f), m_count(0), m_grassTex(NULL)
 
     m_count = m_faces.size();
 
+    // faces are kept in memory and also copied to VBO
+    m_memory = sizeof(GrassFace) * m_faces.capacity();
     if (Video::instance->m_haveVBO)
     {
-        glGenBuffersARB(1, (GLuint*)&m_buffer);
-
-        if (m_count > 0)
-        {
-            glBindBufferARB(GL_ARRAY_BUFFER_ARB, m_buffer);
-            glBufferDataARB(GL_ARRAY_BUFFER_ARB, sizeof(GrassFace)*m_count, &m_faces[0], GL_DYNAMIC_DRAW_ARB);
-        }
-
-        glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0);
+        Loader::runOnMain(upload, this);
+        m_memory += sizeof(GrassFace) * m_count;
     }
+    MemoryBudget::add(MemoryBudget::Grass, m_memory);
 
     m_grassTex = Video::instance->loadTexture("grassThingy");
     m_grassTex->setWrap(Texture::Clamp);
 }
 
+void Grass::upload(void* grass)
+{
+    Grass* self = static_cast<Grass*>(grass);
+
+    glGenBuffersARB(1, (GLuint*)&self->m_buffer);
+
+    if (self->m_count > 0)
+    {
+        glBindBufferARB(GL_ARRAY_BUFFER_ARB, self->m_buffer);
+        glBufferDataARB(GL_ARRAY_BUFFER_ARB, sizeof(GrassFace)*self->m_count, &self->m_faces[0], GL_DYNAMIC_DRAW_ARB);
+    }
+
+    glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0);
+}
+
 Grass::~Grass()
 {
+    MemoryBudget::remove(MemoryBudget::Grass, m_memory);
     if (Video::instance->m_haveVBO)
     {
         glDeleteBuffersARB(2, (GLuint*)&m_buffer);
@@ -133,6 +148,8 @@ void Grass::render() const
         return;
     }
 
+    ProfileZone zone("Grass::render", true);
+
     m_grassTex->bind();
 
     glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT);
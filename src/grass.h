@@ -38,6 +38,9 @@ private:
     unsigned int      m_buffer;
     vector<GrassFace> m_faces;
     Texture*          m_grassTex;  
+    size_t            m_memory;
+
+    static void upload(void* grass); // on main thread
 };
 
 #endif
@@ -2,6 +2,7 @@
 #include "shader.h"
 #include "framebuffer.h"
 #include "config.h"
+#include "profiler.h"
 
 HDR::HDR() :
     m_downsample(NULL),
@@ -159,6 +160,8 @@ void HDR::begin()
     {
         return;
     }
+
+    ProfileZone zone("HDR::begin", true);
     
     m_fboSource->bind();
 }
@@ -169,6 +172,8 @@ void HDR::end()
     {
         return;
     }
+
+    ProfileZone zone("HDR::end", true);
     
     m_fboSource->unbind();
 }
@@ -180,6 +185,8 @@ void HDR::render()
         return;
     }
 
+    ProfileZone zone("HDR::render", true);
+
     GLint draw_buffer;
     glGetIntegerv(GL_DRAW_BUFFER, &draw_buffer);
     
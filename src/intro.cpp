@@ -3,6 +3,7 @@
 #include "texture.h"
 #include "font.h"
 #include "mesh.h"
+#include "memory_budget.h"
 
 static const float FADE_IN_SECS = 2.0f;
 static const float BALL_KICK_SECS = 3.0f;
@@ -31,7 +32,7 @@ static void OnForce(const NewtonBody* body)
 
 Intro::Intro() : m_timePassed(0), m_nextState(false), m_ballKicked(false), m_mesh(NULL)
 {
-    m_newtonWorld = NewtonCreate(NULL, NULL);
+    m_newtonWorld = NewtonCreate(MemoryBudget::newtonAlloc, MemoryBudget::newtonFree);
 
     vector<UV> piece_uv;
 
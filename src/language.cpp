@@ -2,7 +2,6 @@
 #include "xml.h"
 #include "file.h"
 #include "config.h"
-#include <physfs.h>
 
 template <class Language> Language* System<Language>::instance = NULL;
 
@@ -85,6 +84,7 @@ Language::Language()
     REGISTER_TEXT_TYPE(CPU_PLAYER);
     REGISTER_TEXT_TYPE(REMOTE_PLAYER);
     REGISTER_TEXT_TYPE(WAIT_PLAYERS);
+    REGISTER_TEXT_TYPE(LOADING);
 
     REGISTER_TEXT_TYPE(LANG_ENGLISH);
     REGISTER_TEXT_TYPE(LANG_LATVIAN);
@@ -148,16 +148,15 @@ StringVector Language::getAvailable() const
 {
     StringVector result;
 
-    char** files = PHYSFS_enumerateFiles("/data/language/");
-    for (char** i = files; *i != NULL; i++)
+    StringVector files = File::enumerate("/data/language/");
+    for each_const(StringVector, files, iter)
     {
-        string name = *i;
+        const string& name = *iter;
         if (name.size() > 4 && name.substr(name.size()-4, 4) == ".xml")
         {
             result.push_back(name.substr(0, name.size()-4));
         }
     }
-    PHYSFS_freeList(files);
 
     return result;
 }
@@ -82,6 +82,7 @@ enum TextType
     TEXT_CPU_PLAYER,
     TEXT_REMOTE_PLAYER,
     TEXT_WAIT_PLAYERS,
+    TEXT_LOADING,
 	TEXT_CREDITS_SCREEN,
 
     TEXT_LANG_ENGLISH,
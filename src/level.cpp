@@ -1,5 +1,5 @@
 #include "level.h"
-#include "file.h"
+#include "level_compiler.h"
 #include "xml.h"
 #include "video.h"
 #include "world.h"
@@ -12,46 +12,46 @@
 #include "audio.h"
 #include "config.h"
 
-Level::Level() : m_gravity(0.0f, -9.81f, 0.0f), m_skyboxName(),
+Level::Level() : m_football(NULL), m_field(NULL), m_ground(NULL),
+    m_gravity(0.0f, -9.81f, 0.0f), m_skyboxName(),
     m_hdr_eps(0.60f), m_hdr_exp(-0.35f), m_hdr_mul(1.0f, 1.0f, 0.8f, 1.0f)
 {
     m_properties = new Properties();
 }
 
 void Level::load(const string& levelFile)
-{
-    StringSet tmp;
-    load(levelFile, tmp);
-}
-
-void Level::load(const string& levelFile, StringSet& loaded)
 {
     clog << "Reading '" << levelFile << "' data." << endl;
 
-    if (foundIn(loaded, levelFile))
-    {
-        clog << "ERROR: " << levelFile << " already is loaded!" << endl;
-        return;
-    }
-    loaded.insert(levelFile);
+    // linked files are already included in compiled level
+    XMLdocument xml;
+    LevelCompiler::load(levelFile, xml);
 
-    XMLnode xml;
-    File::Reader in("/data/level/" + levelFile);
-    if (!in.is_open())
+    // decode all collision sounds at once, before properties ask for them one by one
+    StringVector sounds;
+    for each_const(XMLelements, xml.root().childs, iter)
     {
-        throw Exception("Level file '" + levelFile + "' not found");  
+        if (iter->name == "properties" || iter->name == "defaultProperties")
+        {
+            for each_const(XMLelements, iter->childs, n)
+            {
+                if (n->name == "sound")
+                {
+                    sounds.push_back(n->getAttribute("name"));
+                }
+            }
+        }
     }
-    xml.load(in);
-    in.close();
+    Audio::instance->preloadSounds(sounds);
 
-    for each_const(XMLnodes, xml.childs, iter)
+    for each_const(XMLelements, xml.root().childs, iter)
     {
-        const XMLnode& node = *iter;
+        const XMLelement& node = *iter;
         if (node.name == "hdr")
         {
-            for each_const(XMLnodes, node.childs, iter)
+            for each_const(XMLelements, node.childs, iter)
             {
-                const XMLnode& node = *iter;
+                const XMLelement& node = *iter;
                 if (node.name == "eps")
                 {
                     m_hdr_eps = node.getAttribute<float>("value");
@@ -82,15 +82,11 @@ void Level::load(const string& levelFile, StringSet& loaded)
         {
             m_skyboxName = node.getAttribute("name");
         }
-        else if (node.name == "link")
-        {
-            load(node.getAttribute("file"), loaded);
-        }
         else if (node.name == "bodies")
         {
-            for each_const(XMLnodes, node.childs, iter)
+            for each_const(XMLelements, node.childs, iter)
             {
-                const XMLnode& node = *iter;
+                const XMLelement& node = *iter;
                 if (node.name == "body")
                 {
                     string id = node.getAttribute("id");
@@ -104,9 +100,9 @@ void Level::load(const string& levelFile, StringSet& loaded)
         }
         else if (node.name == "materials")
         {
-            for each_const(XMLnodes, node.childs, iter)
+            for each_const(XMLelements, node.childs, iter)
             {
-                const XMLnode& node = *iter;
+                const XMLelement& node = *iter;
                 if (node.name == "material")
                 {
                     m_materials.insert(make_pair(node.getAttribute("id"), new Material(node)));
@@ -119,9 +115,9 @@ void Level::load(const string& levelFile, StringSet& loaded)
         }
         else if (node.name == "collisions")
         {
-            for each_const(XMLnodes, node.childs, iter)
+            for each_const(XMLelements, node.childs, iter)
             {
-                const XMLnode& node = *iter;
+                const XMLelement& node = *iter;
                 if (node.name == "collision")
                 {
                     m_collisions[node.getAttribute("id")] = Collision::create(node, this);
@@ -134,9 +130,9 @@ void Level::load(const string& levelFile, StringSet& loaded)
         }
         else if (node.name == "joints")
         {
-            for each_const(XMLnodes, node.childs, iter)
+            for each_const(XMLelements, node.childs, iter)
             {
-                const XMLnode& node = *iter;
+                const XMLelement& node = *iter;
                 if (node.name == "joint")
                 {
                     // TODO: load joints
@@ -157,15 +153,15 @@ void Level::load(const string& levelFile, StringSet& loaded)
         }
         else if (node.name == "fences")
         {
-            for each_const(XMLnodes, node.childs, iter)
+            for each_const(XMLelements, node.childs, iter)
             {
-                const XMLnode& node = *iter;
+                const XMLelement& node = *iter;
                 if (node.name == "fence")
                 {
                     vector<Vector> points;
-                    for each_const(XMLnodes, node.childs, iter)
+                    for each_const(XMLelements, node.childs, iter)
                     {
-                        const XMLnode& node = *iter;
+                        const XMLelement& node = *iter;
                         if (node.name == "point")
                         {
                             points.push_back(node.getAttributesInVector("xyz"));
@@ -196,6 +192,10 @@ void Level::load(const string& levelFile, StringSet& loaded)
     {
         throw Exception("Skybox not specified in level file");
     }
+
+    m_football = getBody("football");
+    m_field = getBody("field");
+    m_ground = getBody("level");
 }
 
 Level::~Level()
@@ -5,7 +5,7 @@
 #include "common.h"
 #include "vmath.h"
 
-class XMLnode;
+class XMLelement;
 class Material;    
 class Properties;
 class Collision;
@@ -27,12 +27,16 @@ public:
     Level();
     ~Level();
     void  load(const string& levelFile);
-    void  load(const string& levelFile, StringSet& loaded);
     void  render() const;
     void  prepare();
     Body* getBody(const string& id) const;
     Collision* getCollision(const string& id) const;
 
+    // bodies used every frame, resolved once after loading
+    Body*           m_football;
+    Body*           m_field;
+    Body*           m_ground;
+
     Vector          m_gravity;
     BodiesMap       m_bodies;
     CollisionsMap   m_collisions;
@@ -0,0 +1,602 @@
+#include <cstring>
+#include <ctime>
+
+#include <expat.h>
+
+#include "level_compiler.h"
+#include "xml.h"
+#include "file.h"
+
+static const string CACHE_DIR = "/cache/level";
+static const unsigned int LEVEL_MAGIC = 0x4C443353; // "S3DL"
+static const unsigned int LEVEL_VERSION = 2; // 2: numbers parsed by parseNumber
+
+// blob is header, sources, elements, attributes and strings;
+// elements are in document order, each followed by its children,
+// attributes of elements are stored in the same order
+struct LevelHeader
+{
+    unsigned int magic;
+    unsigned int version;
+    unsigned int sourceCount;
+    unsigned int elementCount;
+    unsigned int attributeCount;
+    unsigned int stringsSize;
+};
+
+struct LevelSource
+{
+    unsigned int name;
+    unsigned int size; // blob is invalid when any source changes
+    unsigned int time;
+};
+
+struct LevelElement
+{
+    unsigned int name;
+    unsigned int value;
+    unsigned int line;
+    unsigned int childCount;
+    unsigned int attributeCount;
+};
+
+struct LevelAttribute
+{
+    unsigned int name;
+    unsigned int value;
+    unsigned int numeric;
+    float        number;
+};
+
+typedef map<unsigned int, const string*> NameMap;
+
+static const size_t SKIPPED = ~static_cast<size_t>(0); // element is not written
+
+static string getSourceName(const string& levelFile)
+{
+    return "/data/level/" + levelFile;
+}
+
+static string getCacheName(const string& levelFile)
+{
+    return CACHE_DIR + "/" + levelFile + ".bin";
+}
+
+static void getSourceStamp(const string& levelFile, unsigned int& size, unsigned int& time)
+{
+    File::Reader in(getSourceName(levelFile));
+    size = (in.is_open() ? static_cast<unsigned int>(in.size()) : 0);
+    time = static_cast<unsigned int>(File::modified(getSourceName(levelFile)));
+}
+
+static bool isSpace(char c)
+{
+    return c=='\n' || c=='\t' || c==' ' || c=='\r';
+}
+
+// writes records while expat parses, no document tree is built;
+// linked files are compiled in place of <link> element
+class Compiler
+{
+public:
+    Compiler(const string& levelFile) : m_parser(NULL)
+    {
+        m_strings.push_back(0); // offset 0 is empty string
+        m_loaded.insert(levelFile);
+        compileFile(levelFile);
+    }
+
+    void write(vector<char>& blob) const
+    {
+        LevelHeader header;
+        header.magic = LEVEL_MAGIC;
+        header.version = LEVEL_VERSION;
+        header.sourceCount = static_cast<unsigned int>(m_sources.size());
+        header.elementCount = static_cast<unsigned int>(m_elements.size());
+        header.attributeCount = static_cast<unsigned int>(m_attributes.size());
+        header.stringsSize = static_cast<unsigned int>(m_strings.size());
+
+        blob.clear();
+        append(blob, &header, 1);
+        append(blob, &m_sources[0], m_sources.size());
+        append(blob, &m_elements[0], m_elements.size());
+        if (!m_attributes.empty())
+        {
+            append(blob, &m_attributes[0], m_attributes.size());
+        }
+        append(blob, &m_strings[0], m_strings.size());
+    }
+
+private:
+    vector<LevelSource>    m_sources;
+    vector<LevelElement>   m_elements;
+    vector<LevelAttribute> m_attributes;
+    vector<char>           m_strings;
+    UIntMap                m_offsets;
+    StringSet              m_loaded;
+
+    // state of file being parsed, saved while linked file is compiled
+    XML_Parser             m_parser;
+    vector<size_t>         m_open;      // element index or SKIPPED
+    vector<size_t>         m_textStart;
+    vector<char>           m_text;      // text of all open elements
+
+    // exceptions must not pass through expat, they stop parser instead
+    string                 m_error;
+
+    void compileFile(const string& levelFile)
+    {
+        File::Contents contents(getSourceName(levelFile));
+        if (!contents.is_open())
+        {
+            throw Exception("Level file '" + levelFile + "' not found");
+        }
+
+        LevelSource source;
+        source.name = addString(levelFile.c_str());
+        getSourceStamp(levelFile, source.size, source.time);
+        m_sources.push_back(source);
+
+        XML_Parser parser = XML_ParserCreate(NULL);
+        if (parser == NULL)
+        {
+            throw Exception("Error creating XML parser");
+        }
+
+        XML_Parser outerParser = m_parser;
+        vector<size_t> outerOpen;
+        outerOpen.swap(m_open);
+        m_parser = parser;
+
+        XML_SetUserData(parser, static_cast<void*>(this));
+        XML_SetStartElementHandler(parser, StartElementHandler);
+        XML_SetEndElementHandler(parser, EndElementHandler);
+        XML_SetCharacterDataHandler(parser, CharacterDataHandler);
+
+        // whole file is available, usually memory mapped, so it is parsed in one call
+        string error;
+        if (XML_Parse(parser, contents.data(), static_cast<int>(contents.size()), 1) == XML_STATUS_ERROR)
+        {
+            if (m_error.empty())
+            {
+                int c = static_cast<int>(XML_GetErrorColumnNumber(parser));
+                int l = static_cast<int>(XML_GetErrorLineNumber(parser));
+                const XML_LChar* err = XML_ErrorString(XML_GetErrorCode(parser));
+                error = "XML parser error in '" + levelFile + "' (" + cast<string>(l) + ", " + cast<string>(c) + "): " + string(err);
+            }
+            else
+            {
+                error.swap(m_error);
+            }
+        }
+
+        XML_ParserFree(parser);
+        m_parser = outerParser;
+        m_open.swap(outerOpen);
+
+        if (!error.empty())
+        {
+            throw error;
+        }
+        if (m_elements.empty())
+        {
+            throw Exception("XML document is empty");
+        }
+    }
+
+    void startElement(const char* name, const char** atts)
+    {
+        // root of linked file and <link> itself are not written
+        const bool linked = !m_elements.empty() && m_open.empty();
+        if (linked || (m_open.size() == 1 && strcmp(name, "link") == 0))
+        {
+            m_open.push_back(SKIPPED);
+            m_textStart.push_back(m_text.size());
+            if (!linked)
+            {
+                link(atts);
+            }
+            return;
+        }
+
+        if (!m_elements.empty())
+        {
+            // parent of linked file sections is root of first file
+            size_t parent = (m_open.back() == SKIPPED ? 0 : m_open.back());
+            m_elements[parent].childCount++;
+        }
+
+        LevelElement element;
+        element.name = addString(name);
+        element.value = 0;
+        element.line = XML_GetCurrentLineNumber(m_parser);
+        element.childCount = 0;
+        element.attributeCount = 0;
+
+        for (; *atts != NULL; atts += 2)
+        {
+            LevelAttribute attribute;
+            attribute.name = addString(atts[0]);
+            attribute.value = addString(atts[1]);
+            // only plain numbers, everything else is converted later as before
+            attribute.number = 0.0f;
+            attribute.numeric = parseNumber(atts[1], attribute.number) ? 1 : 0;
+            m_attributes.push_back(attribute);
+            element.attributeCount++;
+        }
+
+        m_open.push_back(m_elements.size());
+        m_textStart.push_back(m_text.size());
+        m_elements.push_back(element);
+    }
+
+    void endElement()
+    {
+        size_t i = m_textStart.back();
+        size_t j = m_text.size();
+        while (i < j && isSpace(m_text[i]))
+        {
+            i++;
+        }
+        while (j > i && isSpace(m_text[j-1]))
+        {
+            j--;
+        }
+        if (i < j && m_open.back() != SKIPPED)
+        {
+            m_text.resize(j);
+            m_text.push_back(0);
+            m_elements[m_open.back()].value = addString(&m_text[i]);
+        }
+
+        m_text.resize(m_textStart.back());
+        m_textStart.pop_back();
+        m_open.pop_back();
+    }
+
+    void link(const char** atts)
+    {
+        const char* file = NULL;
+        for (; *atts != NULL; atts += 2)
+        {
+            if (strcmp(atts[0], "file") == 0)
+            {
+                file = atts[1];
+            }
+        }
+        if (file == NULL)
+        {
+            throw Exception("Missing attribute 'file' in node 'link' at line " + cast<string>(XML_GetCurrentLineNumber(m_parser)));
+        }
+
+        if (foundIn(m_loaded, string(file)))
+        {
+            clog << "ERROR: " << file << " already is loaded!" << endl;
+            return;
+        }
+        m_loaded.insert(file);
+        compileFile(file);
+    }
+
+    static void XMLCALL StartElementHandler(void *userData, const XML_Char *name, const XML_Char **atts)
+    {
+        Compiler* self = static_cast<Compiler*>(userData);
+        try
+        {
+            self->startElement(name, atts);
+        }
+        catch (const string& error)
+        {
+            self->m_error = error;
+            XML_StopParser(self->m_parser, XML_FALSE);
+        }
+    }
+
+    static void XMLCALL EndElementHandler(void *userData, const XML_Char *name)
+    {
+        static_cast<Compiler*>(userData)->endElement();
+    }
+
+    static void XMLCALL CharacterDataHandler(void *userData, const XML_Char *s, int len)
+    {
+        Compiler* self = static_cast<Compiler*>(userData);
+        self->m_text.insert(self->m_text.end(), s, s + len);
+    }
+
+    template <typename T>
+    static void append(vector<char>& blob, const T* data, size_t count)
+    {
+        const char* bytes = reinterpret_cast<const char*>(data);
+        blob.insert(blob.end(), bytes, bytes + count * sizeof(T));
+    }
+
+    unsigned int addString(const char* str)
+    {
+        if (*str == 0)
+        {
+            return 0;
+        }
+
+        UIntMap::const_iterator iter = m_offsets.find(str);
+        if (iter != m_offsets.end())
+        {
+            return iter->second;
+        }
+
+        unsigned int offset = static_cast<unsigned int>(m_strings.size());
+        m_strings.insert(m_strings.end(), str, str + strlen(str) + 1);
+        m_offsets.insert(make_pair(string(str), offset));
+        return offset;
+    }
+};
+
+class Builder
+{
+public:
+    Builder(XMLdocument& document, const char* blob) : m_document(document)
+    {
+        const LevelHeader* header = reinterpret_cast<const LevelHeader*>(blob);
+        const LevelSource* sources = reinterpret_cast<const LevelSource*>(header + 1);
+
+        m_element = reinterpret_cast<const LevelElement*>(sources + header->sourceCount);
+        m_attribute = reinterpret_cast<const LevelAttribute*>(m_element + header->elementCount);
+
+        // one copy for all values, names are interned
+        const char* strings = reinterpret_cast<const char*>(m_attribute + header->attributeCount);
+        m_document.clear();
+        m_strings = m_document.copy(strings, header->stringsSize);
+    }
+
+    void build()
+    {
+        buildElement(NULL);
+    }
+
+private:
+    XMLdocument&          m_document;
+    const LevelElement*   m_element;
+    const LevelAttribute* m_attribute;
+    const char*           m_strings;
+    NameMap               m_names;
+
+    const string& getName(unsigned int offset)
+    {
+        NameMap::const_iterator iter = m_names.find(offset);
+        if (iter != m_names.end())
+        {
+            return *iter->second;
+        }
+        const string& name = m_document.intern(m_strings + offset);
+        m_names.insert(make_pair(offset, &name));
+        return name;
+    }
+
+    void buildElement(XMLelement* parent)
+    {
+        const LevelElement* element = m_element++;
+
+        XMLelement* node = m_document.addElement(parent, getName(element->name), element->line);
+        node->value = m_strings + element->value;
+
+        // attributes are prepended, so add them backwards to keep order
+        const LevelAttribute* attributes = m_attribute;
+        m_attribute += element->attributeCount;
+        for (int i = static_cast<int>(element->attributeCount) - 1; i >= 0; i--)
+        {
+            const LevelAttribute& attribute = attributes[i];
+            XMLattribute* attr = m_document.addAttribute(node, getName(attribute.name), m_strings + attribute.value);
+            attr->numeric = (attribute.numeric != 0);
+            attr->number = attribute.number;
+        }
+
+        for (unsigned int i = 0; i < element->childCount; i++)
+        {
+            buildElement(node);
+        }
+    }
+};
+
+static bool isValid(const char* blob, size_t size)
+{
+    if (size < sizeof(LevelHeader))
+    {
+        return false;
+    }
+
+    const LevelHeader* header = reinterpret_cast<const LevelHeader*>(blob);
+    if (header->magic != LEVEL_MAGIC || header->version != LEVEL_VERSION || header->elementCount == 0)
+    {
+        return false;
+    }
+
+    // each count alone must fit, so sum below can't overflow
+    if (header->sourceCount > size / sizeof(LevelSource) ||
+        header->elementCount > size / sizeof(LevelElement) ||
+        header->attributeCount > size / sizeof(LevelAttribute) ||
+        header->stringsSize > size)
+    {
+        return false;
+    }
+
+    size_t expected = sizeof(LevelHeader) +
+                      header->sourceCount * sizeof(LevelSource) +
+                      header->elementCount * sizeof(LevelElement) +
+                      header->attributeCount * sizeof(LevelAttribute) +
+                      header->stringsSize;
+    if (expected != size || header->stringsSize == 0 || blob[size - 1] != 0)
+    {
+        return false;
+    }
+
+    // Builder trusts all counts and offsets, so corrupted cache is
+    // checked here: every element must be visited exactly once in
+    // document order and every attribute must belong to some element
+    const LevelSource* sources = reinterpret_cast<const LevelSource*>(header + 1);
+    const LevelElement* elements = reinterpret_cast<const LevelElement*>(sources + header->sourceCount);
+    const LevelAttribute* attributes = reinterpret_cast<const LevelAttribute*>(elements + header->elementCount);
+
+    size_t pending = 1; // elements still to be visited by Builder
+    size_t attributeCount = 0;
+    for (unsigned int i = 0; i < header->elementCount; i++)
+    {
+        const LevelElement& element = elements[i];
+        if (pending == 0 || element.name >= header->stringsSize || element.value >= header->stringsSize ||
+            element.childCount >= header->elementCount || 
+            element.attributeCount > header->attributeCount - attributeCount)
+        {
+            return false;
+        }
+        pending = pending - 1 + element.childCount;
+        attributeCount += element.attributeCount;
+    }
+    if (pending != 0 || attributeCount != header->attributeCount)
+    {
+        return false;
+    }
+
+    for (unsigned int i = 0; i < header->attributeCount; i++)
+    {
+        if (attributes[i].name >= header->stringsSize || attributes[i].value >= header->stringsSize)
+        {
+            return false;
+        }
+    }
+
+    // falls back to xml when any source file is changed
+    const char* strings = blob + size - header->stringsSize;
+    for (unsigned int i = 0; i < header->sourceCount; i++)
+    {
+        if (sources[i].name >= header->stringsSize)
+        {
+            return false;
+        }
+        unsigned int sourceSize, sourceTime;
+        getSourceStamp(strings + sources[i].name, sourceSize, sourceTime);
+        if (sources[i].size != sourceSize || sources[i].time != sourceTime)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void LevelCompiler::compile(const string& levelFile, vector<char>& blob)
+{
+    Compiler(levelFile).write(blob);
+}
+
+static void collectValues(const XMLelement& node, vector<const char*>& values)
+{
+    for (const XMLattribute* attribute = node.attributes(); attribute != NULL; attribute = attribute->next)
+    {
+        if (attribute->numeric)
+        {
+            values.push_back(attribute->value);
+        }
+    }
+    for each_const(XMLelements, node.childs, iter)
+    {
+        collectValues(*iter, values);
+    }
+}
+
+static double seconds(clock_t start)
+{
+    return static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+}
+
+void LevelCompiler::benchmark(const string& levelFile, int count)
+{
+    clog << "Benchmarking level '" << levelFile << "' " << count << " times..." << endl;
+
+    vector<char> blob;
+    clock_t start = clock();
+    for (int i = 0; i < count; i++)
+    {
+        compile(levelFile, blob);
+    }
+    double xmlTime = seconds(start);
+
+    XMLdocument document;
+    start = clock();
+    for (int i = 0; i < count; i++)
+    {
+        Builder(document, &blob[0]).build();
+    }
+    double compiledTime = seconds(start);
+
+    vector<const char*> values;
+    collectValues(document.root(), values);
+
+    // sum keeps optimizer from removing conversions
+    float sum = 0.0f;
+    start = clock();
+    for (int i = 0; i < count; i++)
+    {
+        for each_const(vector<const char*>, values, iter)
+        {
+            sum += cast<float>(*iter);
+        }
+    }
+    double castTime = seconds(start);
+
+    start = clock();
+    for (int i = 0; i < count; i++)
+    {
+        for each_const(vector<const char*>, values, iter)
+        {
+            sum += parseAttribute<float>(*iter);
+        }
+    }
+    double parseTime = seconds(start);
+
+    std::cout << "xml\t" << xmlTime / count << endl;
+    std::cout << "compiled\t" << compiledTime / count << endl;
+    std::cout << "cast\t" << castTime / count << '\t' << values.size() << endl;
+    std::cout << "parse\t" << parseTime / count << '\t' << values.size() << endl;
+
+    clog << "Level from xml " << xmlTime * 1000 / count << " ms, compiled "
+         << compiledTime * 1000 / count << " ms, " << values.size() << " numbers with cast "
+         << castTime * 1000 / count << " ms, parsed " << parseTime * 1000 / count
+         << " ms (checksum " << sum << ")" << endl;
+}
+
+void LevelCompiler::load(const string& levelFile, XMLdocument& document)
+{
+    {
+        File::Mapping cache(getCacheName(levelFile));
+        if (cache.is_open() && isValid(cache.data(), cache.size()))
+        {
+            Builder(document, cache.data()).build();
+            return;
+        }
+    }
+
+    clog << "Compiling level '" << levelFile << "'." << endl;
+
+    vector<char> blob;
+    compile(levelFile, blob);
+
+    // cache is only optimization, failing to write it is not an error
+    try
+    {
+        if (!File::exists(CACHE_DIR))
+        {
+            File::makeDir(CACHE_DIR);
+        }
+
+        File::Writer out(getCacheName(levelFile));
+        if (out.is_open())
+        {
+            out.write(&blob[0], blob.size());
+            out.close();
+        }
+    }
+    catch (const string& error)
+    {
+        clog << "Failed to write compiled level '" << levelFile << "': " << error << endl;
+    }
+
+    Builder(document, &blob[0]).build();
+}
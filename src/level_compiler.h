@@ -0,0 +1,24 @@
+#ifndef __LEVEL_COMPILER_H__
+#define __LEVEL_COMPILER_H__
+
+#include "common.h"
+
+class XMLdocument;
+
+// flattens level xml with all linked files into one binary blob of
+// string, element and attribute arrays, numbers are converted already;
+// blob is cached in write directory and rebuilt when any source changes
+class LevelCompiler
+{
+public:
+    // fills document from compiled level, compiles it first if needed
+    static void load(const string& levelFile, XMLdocument& document);
+
+    static void compile(const string& levelFile, vector<char>& blob);
+
+    // times xml parsing, loading of compiled level and number conversion,
+    // set from command line: --benchmark-level <level> [count]
+    static void benchmark(const string& levelFile, int count);
+};
+
+#endif
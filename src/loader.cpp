@@ -0,0 +1,178 @@
+#include <GL/glfw.h>
+
+#include "loader.h"
+
+// main thread executes marshalled tasks this long per frame
+static const double UPDATE_TIME = 0.015;
+
+static GLFWthread thread = -1;
+static GLFWmutex mutex = NULL;
+static GLFWcond cond = NULL;
+static GLFWthread mainThread = -1;
+static volatile bool running = false; // set before worker starts
+
+static Loader::Task job = NULL;
+static void* jobArg = NULL;
+static volatile bool jobDone = false;
+static string jobError;
+
+static Loader::Task pending = NULL;
+static void* pendingArg = NULL;
+static string pendingError;
+
+static volatile float progress = 0.0f;
+
+static void GLFWCALL loaderThread(void* arg)
+{
+    string error;
+    try
+    {
+        job(jobArg);
+    }
+    catch (const string& exception)
+    {
+        error = exception;
+    }
+
+    glfwLockMutex(mutex);
+    jobError = error;
+    jobDone = true;
+    glfwBroadcastCond(cond);
+    glfwUnlockMutex(mutex);
+}
+
+void Loader::start(Task task, void* arg)
+{
+    assert(!running);
+
+    mainThread = glfwGetThreadID();
+    mutex = glfwCreateMutex();
+    cond = glfwCreateCond();
+    job = task;
+    jobArg = arg;
+    jobDone = false;
+    jobError.clear();
+    progress = 0.0f;
+
+    running = true;
+    thread = glfwCreateThread(loaderThread, NULL);
+    if (thread < 0)
+    {
+        // no threads, load synchronously
+        running = false;
+        glfwDestroyCond(cond);
+        glfwDestroyMutex(mutex);
+        cond = NULL;
+        mutex = NULL;
+        try
+        {
+            task(arg);
+        }
+        catch (const string& exception)
+        {
+            jobError = exception;
+        }
+        jobDone = true;
+    }
+}
+
+bool Loader::update()
+{
+    if (thread < 0)
+    {
+        return jobDone;
+    }
+
+    const double end = glfwGetTime() + UPDATE_TIME;
+
+    glfwLockMutex(mutex);
+    while (!jobDone)
+    {
+        if (pending != NULL)
+        {
+            try
+            {
+                pending(pendingArg);
+            }
+            catch (const string& exception)
+            {
+                pendingError = exception;
+            }
+            pending = NULL;
+            glfwBroadcastCond(cond);
+        }
+
+        const double left = end - glfwGetTime();
+        if (left <= 0.0)
+        {
+            break;
+        }
+        glfwWaitCond(cond, mutex, left);
+    }
+    bool done = jobDone;
+    glfwUnlockMutex(mutex);
+
+    return done;
+}
+
+void Loader::finish()
+{
+    if (thread >= 0)
+    {
+        while (!update())
+        {
+        }
+        glfwWaitThread(thread, GLFW_WAIT);
+        running = false;
+        glfwDestroyCond(cond);
+        glfwDestroyMutex(mutex);
+        thread = -1;
+        cond = NULL;
+        mutex = NULL;
+    }
+
+    job = NULL;
+    if (!jobError.empty())
+    {
+        string error;
+        error.swap(jobError);
+        throw Exception(error);
+    }
+}
+
+void Loader::runOnMain(Task task, void* arg)
+{
+    if (!running || glfwGetThreadID() == mainThread)
+    {
+        task(arg);
+        return;
+    }
+
+    glfwLockMutex(mutex);
+    pending = task;
+    pendingArg = arg;
+    pendingError.clear();
+    glfwBroadcastCond(cond);
+    while (pending != NULL)
+    {
+        glfwWaitCond(cond, mutex, GLFW_INFINITY);
+    }
+    string error;
+    error.swap(pendingError);
+    glfwUnlockMutex(mutex);
+
+    if (!error.empty())
+    {
+        throw Exception(error);
+    }
+}
+
+void Loader::setProgress(float value)
+{
+    progress = value;
+}
+
+float Loader::getProgress()
+{
+    return progress;
+}
@@ -0,0 +1,29 @@
+#ifndef __LOADER_H__
+#define __LOADER_H__
+
+#include "common.h"
+
+// runs one loading job in background thread, worker marshals
+// OpenGL and OpenAL work back to main thread with runOnMain
+class Loader
+{
+public:
+    typedef void (*Task)(void* arg);
+
+    static void start(Task job, void* arg);
+
+    // main thread, executes marshalled tasks, returns true when job is done
+    static bool update();
+
+    // main thread, waits for job, rethrows its error
+    static void finish();
+
+    // blocks until task is executed on main thread, runs
+    // it immediately if called from main thread or no job is running
+    static void runOnMain(Task task, void* arg);
+
+    static void setProgress(float progress);
+    static float getProgress();
+};
+
+#endif
@@ -0,0 +1,126 @@
+#include "loading.h"
+#include "loader.h"
+#include "world.h"
+#include "network.h"
+#include "video.h"
+#include "font.h"
+#include "language.h"
+#include "colors.h"
+
+static const int BAR_WIDTH = 300;
+static const int BAR_HEIGHT = 8;
+
+Loading::Loading(::World* world) :
+    m_world(world),
+    m_threaded(false),
+    m_loaded(false),
+    m_font(Font::get("Arial_32pt_bold"))
+{
+}
+
+Loading::~Loading()
+{
+    if (m_threaded)
+    {
+        // game closed while loading
+        try
+        {
+            Loader::finish();
+        }
+        catch (const string& exception)
+        {
+            clog << "ERROR: " << exception << endl;
+        }
+    }
+    delete m_world;
+}
+
+void Loading::init()
+{
+    // network is updated on main thread and shares players with world,
+    // so network games are loaded after first frame in main thread
+    if (Network::instance->m_isSingle)
+    {
+        Loader::start(loadWorld, m_world);
+        m_threaded = true;
+    }
+}
+
+void Loading::loadWorld(void* world)
+{
+    static_cast< ::World*>(world)->load();
+}
+
+void Loading::control()
+{
+}
+
+void Loading::update(float delta)
+{
+}
+
+void Loading::updateStep(float delta)
+{
+}
+
+void Loading::prepare()
+{
+}
+
+void Loading::render() const
+{
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    const IntPair res = Video::instance->getResolution();
+    const float progress = Loader::getProgress();
+    const string text = Language::instance->get(TEXT_LOADING)(static_cast<int>(progress * 100.0f));
+
+    m_font->begin();
+
+    glTranslatef(static_cast<float>(res.first / 2), static_cast<float>(res.second / 2), 0.0f);
+    glColor3fv(White.v);
+    m_font->render(text, Font::Align_Center);
+
+    const float x = static_cast<float>(-BAR_WIDTH / 2);
+    const float y = static_cast<float>(-2 * BAR_HEIGHT);
+    glColor3fv(Grey.v);
+    Video::instance->renderRect(Vector(x, y, 0.0f), Vector(x + BAR_WIDTH, y + BAR_HEIGHT, 0.0f));
+    glColor3fv(Yellow.v);
+    Video::instance->renderRect(Vector(x, y, 0.0f), Vector(x + BAR_WIDTH * progress, y + BAR_HEIGHT, 0.0f));
+
+    m_font->end();
+}
+
+State::Type Loading::progress()
+{
+    if (m_loaded)
+    {
+        return State::World;
+    }
+
+    if (m_threaded)
+    {
+        if (!Loader::update())
+        {
+            return State::Current;
+        }
+        m_threaded = false;
+        Loader::finish();
+    }
+    else
+    {
+        m_world->load();
+    }
+
+    m_world->start();
+    m_loaded = true;
+    return State::World;
+}
+
+State* Loading::next()
+{
+    ::World* world = m_world;
+    m_world = NULL;
+    return world;
+}
@@ -0,0 +1,35 @@
+#ifndef __LOADING_H__
+#define __LOADING_H__
+
+#include "common.h"
+#include "state.h"
+
+class World;
+class Font;
+
+// shows progress while world is loaded in background thread
+class Loading : public State
+{
+public:
+    Loading(::World* world);
+    ~Loading();
+
+    void init();
+    void control();
+    void update(float delta);
+    void updateStep(float delta);
+    void prepare();
+    void render() const;
+    State::Type progress();
+    State* next();
+
+private:
+    ::World*    m_world;
+    bool        m_threaded;
+    bool        m_loaded;
+    const Font* m_font;
+
+    static void loadWorld(void* world);
+};
+
+#endif
@@ -16,6 +16,11 @@
 #include "version.h"
 #include "audio.h"
 #include "video.h"
+#include "simulation.h"
+#include "level_compiler.h"
+#include "memory_budget.h"
+#include "object_pool.h"
+#include "benchmark.h"
 
 void display_exception(const string& exception)
 {
@@ -34,7 +39,7 @@ void display_exception(const string& exception)
 #endif
 }
 
-int main(int, char* argv[])
+int main(int argc, char* argv[])
 {
 #ifdef NDEBUG
     std::ofstream log((File::getBase(argv[0], true) +  "log.txt").c_str());
@@ -45,30 +50,83 @@ int main(int, char* argv[])
 
     clog << "Started: " << getDateTime() << endl;
 
-    Randoms::init();
+    string benchmarkLevel;
+    int benchmarkCount = 100;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (string(argv[i]) == "--benchmark-level" && i + 1 < argc)
+        {
+            benchmarkLevel = argv[++i];
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                benchmarkCount = cast<int>(argv[++i]);
+            }
+        }
+        else if (string(argv[i]) == "--simulate" && i + 1 < argc)
+        {
+            g_simulateMatches = cast<int>(argv[++i]);
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                g_simulateSeed = cast<unsigned int>(argv[++i]);
+            }
+        }
+        else if (string(argv[i]) == "--benchmark-properties")
+        {
+            g_propertyLookups = 10000000;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                g_propertyLookups = cast<unsigned int>(argv[++i]);
+            }
+        }
+        else if (string(argv[i]) == "--benchmark" && i + 1 < argc)
+        {
+            g_benchmarkSeconds = cast<float>(argv[++i]);
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                g_benchmarkLevel = argv[++i];
+            }
+        }
+    }
+
+    if (g_simulateSeed != 0)
+    {
+        Randoms::init(g_simulateSeed);
+    }
+    else
+    {
+        Randoms::init();
+    }
 
     try
     {
         File::init(argv[0]);
         try
         {
+            if (!benchmarkLevel.empty())
+            {
+                LevelCompiler::benchmark(benchmarkLevel, benchmarkCount);
+            }
+            else
+            {
 #ifdef __linux__
-            audio_setup();
+                audio_setup();
 #endif
 #ifdef __APPLE__
-            video_setup();
+                video_setup();
 #endif
-            do
-            {
-                Game().run();
-            }
-            while (g_needsToReload);
+                do
+                {
+                    Game().run();
+                }
+                while (g_needsToReload);
 #ifdef __linux__
-            audio_finish();
+                audio_finish();
 #endif
 #ifdef __APPLE__
-            video_finish();
+                video_finish();
 #endif
+            }
         }
         catch (const string& exception)
         {
@@ -83,9 +141,8 @@ int main(int, char* argv[])
 
     clog << "Finished: " << getDateTime() << endl;
 
-#if defined(_DEBUG) && !__MINGW32__ && !__APPLE__ && !__linux__
-    m_dumpMemoryReport();
-#endif
+    ObjectPool::clear();
+    MemoryBudget::dump();
     
 #ifdef NDEBUG
     clog.rdbuf(old_clog);
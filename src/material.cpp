@@ -5,7 +5,7 @@
 #include "level.h"
 #include "world.h"
 
-Material::Material(const XMLnode& node) :
+Material::Material(const XMLelement& node) :
     m_id(),
     m_cAmbient(0.2f, 0.2f, 0.2f),
     m_cSpecular(0.0f, 0.0f, 0.0f),
@@ -15,18 +15,18 @@ Material::Material(const XMLnode& node) :
 {
     m_id = node.getAttribute("id");
 
-    for each_const(XMLnodes, node.childs, iter)
+    for each_const(XMLelements, node.childs, iter)
     {
-        const XMLnode& node = *iter;
+        const XMLelement& node = *iter;
         if (node.name == "texture2D")
         {
             m_texture = Video::instance->loadTexture(node.getAttribute("name"));
         }
         else if (node.name == "colors")
         {
-            for each_const(XMLnodes, node.childs, iter)
+            for each_const(XMLelements, node.childs, iter)
             {
-                const XMLnode& node = *iter;
+                const XMLelement& node = *iter;
                 if (node.name == "ambient")
                 {
                     m_cAmbient = node.getAttributesInVector("rgb");
@@ -6,7 +6,7 @@
 
 class Level;
 class Texture;
-class XMLnode;
+class XMLelement;
 
 class Material : public NoCopy
 {
@@ -21,7 +21,7 @@ public:
 
     void bind() const;
 private: 
-    Material(const XMLnode& node);
+    Material(const XMLelement& node);
 
     Texture* m_texture;
 };
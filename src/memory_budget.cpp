@@ -0,0 +1,203 @@
+#if defined(_MSC_VER)
+#include <intrin.h>
+#pragma intrinsic(_InterlockedExchangeAdd)
+#endif
+
+#include <new>
+#include <cstdlib>
+#include <iomanip>
+
+#include "memory_budget.h"
+
+static const long KB = 1024;
+static const long MB = 1024 * KB;
+
+struct TagInfo
+{
+    const char* name;
+    long        budget;
+};
+
+static const TagInfo tags[MemoryBudget::TagCount] = {
+    { "physics",  32 * MB },
+    { "grass",     8 * MB },
+    { "textures", 96 * MB },
+    { "audio",    64 * MB },
+    { "network",   1 * MB },
+    { "UI",        8 * MB },
+};
+
+struct TagCounters
+{
+    volatile long current;
+    volatile long count;
+    long          peak;
+    unsigned int  allocations;
+};
+
+static TagCounters counters[MemoryBudget::TagCount];
+static volatile long heapCount = 0;
+
+static inline long atomicAdd(volatile long* value, long delta)
+{
+#if defined(_MSC_VER)
+    return _InterlockedExchangeAdd(value, delta) + delta;
+#else
+    return __sync_add_and_fetch(value, delta);
+#endif
+}
+
+void MemoryBudget::add(Tag tag, size_t size)
+{
+    TagCounters& counter = counters[tag];
+    long current = atomicAdd(&counter.current, static_cast<long>(size));
+    atomicAdd(&counter.count, 1);
+
+    // peak and total count can miss concurrent update, they are only statistics
+    if (current > counter.peak)
+    {
+        counter.peak = current;
+    }
+    counter.allocations++;
+}
+
+void MemoryBudget::remove(Tag tag, size_t size)
+{
+    TagCounters& counter = counters[tag];
+    atomicAdd(&counter.current, -static_cast<long>(size));
+    atomicAdd(&counter.count, -1);
+}
+
+void* MemoryBudget::allocate(Tag tag, size_t size)
+{
+    void* ptr = std::malloc(size);
+    if (ptr == NULL)
+    {
+        throw std::bad_alloc();
+    }
+    atomicAdd(&heapCount, 1);
+    add(tag, size);
+    return ptr;
+}
+
+void MemoryBudget::release(Tag tag, void* ptr, size_t size)
+{
+    if (ptr == NULL)
+    {
+        return;
+    }
+    remove(tag, size);
+    std::free(ptr);
+}
+
+void* MemoryBudget::newtonAlloc(int size)
+{
+    return allocate(Physics, static_cast<size_t>(size));
+}
+
+void MemoryBudget::newtonFree(void* ptr, int size)
+{
+    release(Physics, ptr, static_cast<size_t>(size));
+}
+
+const char* MemoryBudget::name(Tag tag)
+{
+    return tags[tag].name;
+}
+
+unsigned long MemoryBudget::heapAllocations()
+{
+    return static_cast<unsigned long>(heapCount);
+}
+
+void MemoryBudget::describe(std::ostream& stream)
+{
+    for (int i = 0; i < TagCount; i++)
+    {
+        const TagCounters& counter = counters[i];
+        stream << "mem " << tags[i].name << "  " << counter.current / KB << " KB  peak "
+               << counter.peak / KB << " / " << tags[i].budget / KB << " KB";
+        if (counter.peak > tags[i].budget)
+        {
+            stream << "  OVER BUDGET";
+        }
+        stream << endl;
+    }
+}
+
+void MemoryBudget::dump()
+{
+    clog << "Memory usage:" << endl;
+    for (int i = 0; i < TagCount; i++)
+    {
+        const TagCounters& counter = counters[i];
+        clog << "  " << std::setw(8) << std::left << tags[i].name << std::right
+             << " peak " << std::setw(7) << counter.peak / KB << " KB"
+             << " of " << std::setw(7) << tags[i].budget / KB << " KB budget, "
+             << counter.allocations << " allocations";
+        if (counter.peak > tags[i].budget)
+        {
+            clog << ", OVER BUDGET";
+        }
+        if (counter.current != 0)
+        {
+            clog << ", not freed " << counter.current << " bytes in " << counter.count << " blocks";
+        }
+        clog << endl;
+    }
+}
+
+// global new only counts, so per frame allocations can be checked
+
+static void* heapAllocate(size_t size)
+{
+    atomicAdd(&heapCount, 1);
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == NULL)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new(size_t size) throw(std::bad_alloc)
+{
+    return heapAllocate(size);
+}
+
+void* operator new[](size_t size) throw(std::bad_alloc)
+{
+    return heapAllocate(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) throw()
+{
+    atomicAdd(&heapCount, 1);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) throw()
+{
+    atomicAdd(&heapCount, 1);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void operator delete(void* ptr) throw()
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) throw()
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) throw()
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) throw()
+{
+    std::free(ptr);
+}
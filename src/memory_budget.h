@@ -0,0 +1,44 @@
+#ifndef __MEMORY_BUDGET_H__
+#define __MEMORY_BUDGET_H__
+
+#include "common.h"
+
+// bytes used by each subsystem, with peak and budget; cheap enough to
+// stay enabled in release, counters are updated atomically because
+// loader thread allocates too; memory that is not allocated with new
+// (GPU and OpenAL buffers, Newton) is reported with add and remove
+class MemoryBudget
+{
+public:
+    enum Tag
+    {
+        Physics,
+        Grass,
+        Textures,
+        Audio,
+        Network,
+        UI,
+
+        TagCount,
+    };
+
+    static void add(Tag tag, size_t size);
+    static void remove(Tag tag, size_t size);
+
+    static void* allocate(Tag tag, size_t size);
+    static void release(Tag tag, void* ptr, size_t size);
+
+    // allocator for NewtonCreate
+    static void* newtonAlloc(int size);
+    static void newtonFree(void* ptr, int size);
+
+    static const char* name(Tag tag);
+
+    // count of all heap allocations since start, includes global new
+    static unsigned long heapAllocations();
+
+    static void describe(std::ostream& stream);
+    static void dump(); // to log, at exit
+};
+
+#endif
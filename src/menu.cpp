@@ -10,6 +10,7 @@
 #include "font.h"
 #include "video.h"
 #include "texture.h"
+#include "mesh.h"
 #include "geometry.h"
 #include "input.h"
 #include "language.h"
@@ -64,16 +65,18 @@ Menu::Menu(Profile* userProfile, int unlockable, int& current) :
 
     const float aspect = (1.0f - resY/resX)/2.0f;
 
-    m_backGround = new Face();
-    m_backGround->vertexes.push_back(Vector::Zero);
-    m_backGround->vertexes.push_back(Vector(0.0f, resY, 0.0f));
-    m_backGround->vertexes.push_back(Vector(resX, 0.0f, 0.0f));
-    m_backGround->vertexes.push_back(Vector(resX, resY, 0.0f));
+    Face backGround;
+    backGround.vertexes.push_back(Vector::Zero);
+    backGround.vertexes.push_back(Vector(0.0f, resY, 0.0f));
+    backGround.vertexes.push_back(Vector(resX, 0.0f, 0.0f));
+    backGround.vertexes.push_back(Vector(resX, resY, 0.0f));
 
-    m_backGround->uv.push_back(UV(0.0f, aspect));
-    m_backGround->uv.push_back(UV(0.0f, 1.0f - aspect));
-    m_backGround->uv.push_back(UV(1.0f, aspect));
-    m_backGround->uv.push_back(UV(1.0f, 1.0f - aspect));
+    backGround.uv.push_back(UV(0.0f, aspect));
+    backGround.uv.push_back(UV(0.0f, 1.0f - aspect));
+    backGround.uv.push_back(UV(1.0f, aspect));
+    backGround.uv.push_back(UV(1.0f, 1.0f - aspect));
+
+    m_backGround = new FaceMesh(backGround);
 
     m_backGroundTexture = Video::instance->loadTexture("background", false);
     m_backGroundTexture->setFilter(Texture::Bilinear);
@@ -693,7 +696,7 @@ Menu::~Menu()
 
 State::Type Menu::progress()
 {
-    return (Network::instance->m_needToStartGame ? State::World : m_state);
+    return (Network::instance->m_needToStartGame ? State::Loading : m_state);
 }
 
 void Menu::setState(State::Type state)
@@ -787,7 +790,7 @@ void Menu::render() const
 
     m_backGroundTexture->bind();
     glDisableClientState(GL_NORMAL_ARRAY);
-    Video::instance->renderFace(*m_backGround);
+    m_backGround->render();
     glEnableClientState(GL_NORMAL_ARRAY);
 
     m_font->begin2();
@@ -8,7 +8,7 @@
 class Music;
 class Game;
 class Font;
-struct Face;
+class Mesh;
 class Texture;
 class Menu;
 class Entry;
@@ -57,7 +57,7 @@ public:
 
 private:
     State::Type  m_state;
-    Face*        m_backGround;
+    Mesh*        m_backGround;
     Texture*     m_backGroundTexture;
 };
 
@@ -281,7 +281,7 @@ void WorldEntry::click(int button)
         Network::instance->setCpuProfiles(Game::instance->m_cpuProfiles, m_switchTo);
 
         m_current = m_switchTo;
-        m_menu->setState(State::World);
+        m_menu->setState(State::Loading);
     }
 }
 
@@ -497,6 +497,6 @@ void MultiWorldEntry::click(int button)
     if ((button == GLFW_MOUSE_BUTTON_LEFT) || (button == GLFW_KEY_ENTER) || (button == GLFW_KEY_KP_ENTER))
     {
         Network::instance->startGame();
-        m_menu->setState(State::World);
+        m_menu->setState(State::Loading);
     }
 }
@@ -1,52 +1,71 @@
 #include "mesh.h"
+#include "loader.h"
 
 Mesh::Mesh(GLenum mode, bool indexed) :
     m_mode(mode),
     m_texcoordOffset(0),
     m_verticesOffset(0),
-    m_indexed(indexed)
+    m_indexed(indexed),
+    m_hasNormals(false)
 {
 }
 
 void Mesh::init()
 {
-    m_indicesCount = static_cast<GLsizei>(m_indices.size());
+    m_indicesCount = static_cast<GLsizei>(m_indexed ? m_indices.size() : m_vertices.size());
+    m_hasNormals = !m_normals.empty();
 
     if (Video::instance->m_haveVBO)
     {
-        glGenBuffersARB( (m_indexed ? 2 : 1), (GLuint*)m_buffers);
+        Loader::runOnMain(upload, this);
+    }
+}
+
+void Mesh::upload(void* mesh)
+{
+    static_cast<Mesh*>(mesh)->uploadBuffers();
+}
 
-        m_texcoordOffset = static_cast<GLuint>(m_normals.size() * sizeof(Vector));
-        m_verticesOffset = m_texcoordOffset + static_cast<GLuint>(m_texcoords.size() * sizeof(Vector));
+void Mesh::uploadBuffers()
+{
+    glGenBuffersARB( (m_indexed ? 2 : 1), (GLuint*)m_buffers);
 
-        GLuint size = m_verticesOffset + static_cast<GLuint>(m_vertices.size() * sizeof(Vector));
+    m_texcoordOffset = static_cast<GLuint>(m_normals.size() * sizeof(Vector));
+    m_verticesOffset = m_texcoordOffset + static_cast<GLuint>(m_texcoords.size() * sizeof(Vector));
 
-        glBindBufferARB(GL_ARRAY_BUFFER_ARB, m_buffers[0]);
-        glBufferDataARB(GL_ARRAY_BUFFER_ARB, size, NULL, GL_STATIC_DRAW_ARB);
+    GLuint size = m_verticesOffset + static_cast<GLuint>(m_vertices.size() * sizeof(Vector));
+
+    glBindBufferARB(GL_ARRAY_BUFFER_ARB, m_buffers[0]);
+    glBufferDataARB(GL_ARRAY_BUFFER_ARB, size, NULL, GL_STATIC_DRAW_ARB);
 
+    if (!m_normals.empty())
+    {
         glBufferSubDataARB(GL_ARRAY_BUFFER_ARB, 0, m_normals.size() * sizeof(Vector), &m_normals[0]);
+    }
+    if (!m_texcoords.empty())
+    {
         glBufferSubDataARB(GL_ARRAY_BUFFER_ARB, m_texcoordOffset, m_texcoords.size() * sizeof(UV), &m_texcoords[0]);
+    }
+    if (!m_vertices.empty())
+    {
         glBufferSubDataARB(GL_ARRAY_BUFFER_ARB, m_verticesOffset, m_vertices.size() * sizeof(Vector), &m_vertices[0]);
+    }
 
-        glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0);
-
-        if (m_indexed)
-        {
-            glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB, m_buffers[1]);
-            glBufferDataARB(GL_ELEMENT_ARRAY_BUFFER_ARB, m_indices.size() * sizeof(unsigned short), &m_indices[0], GL_STATIC_DRAW_ARB);
-            glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB, 0);
+    glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0);
 
-            m_indices.clear();
-        }
-        else
-        {
-            m_indicesCount = static_cast<GLsizei>(m_vertices.size());
-        }
+    if (m_indexed)
+    {
+        glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB, m_buffers[1]);
+        glBufferDataARB(GL_ELEMENT_ARRAY_BUFFER_ARB, m_indices.size() * sizeof(unsigned short), 
+                        m_indices.empty() ? NULL : &m_indices[0], GL_STATIC_DRAW_ARB);
+        glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB, 0);
 
-        m_vertices.clear();
-        m_normals.clear();
-        m_texcoords.clear();
+        m_indices.clear();
     }
+
+    m_vertices.clear();
+    m_normals.clear();
+    m_texcoords.clear();
 }
 
 Mesh::~Mesh()
@@ -62,7 +81,10 @@ void Mesh::render() const
     if (Video::instance->m_haveVBO)
     {
         glBindBufferARB(GL_ARRAY_BUFFER_ARB, m_buffers[0]);
-        glNormalPointer(GL_FLOAT, sizeof(Vector), NULL);
+        if (m_hasNormals)
+        {
+            glNormalPointer(GL_FLOAT, sizeof(Vector), NULL);
+        }
         glTexCoordPointer(2, GL_FLOAT, sizeof(UV), (char*)NULL + m_texcoordOffset);
         glVertexPointer(3, GL_FLOAT, sizeof(Vector), (char*)NULL + m_verticesOffset);
 
@@ -81,8 +103,18 @@ void Mesh::render() const
     }
     else
     {
-        glNormalPointer(GL_FLOAT, sizeof(Vector), &m_normals[0]);
-        glTexCoordPointer(2, GL_FLOAT, sizeof(UV), &m_texcoords[0]);
+        if (m_vertices.empty())
+        {
+            return;
+        }
+        if (!m_normals.empty())
+        {
+            glNormalPointer(GL_FLOAT, sizeof(Vector), &m_normals[0]);
+        }
+        if (!m_texcoords.empty())
+        {
+            glTexCoordPointer(2, GL_FLOAT, sizeof(UV), &m_texcoords[0]);
+        }
         glVertexPointer(3, GL_FLOAT, sizeof(Vector), &m_vertices[0]);
 
         if (m_indexed)
@@ -97,6 +129,15 @@ void Mesh::render() const
     }
 }
 
+FaceMesh::FaceMesh(const Face& face) : Mesh(GL_TRIANGLE_STRIP, false)
+{
+    m_normals = face.normal;
+    m_texcoords = face.uv;
+    m_vertices = face.vertexes;
+
+    init();
+}
+
 CubeMesh::CubeMesh(const Vector& size) : Mesh(GL_TRIANGLES, false)
 {
     // -0.5 .. 0.5
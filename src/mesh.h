@@ -27,6 +27,9 @@ protected:
 
 private:
     GLuint  m_buffers[2];
+
+    static void upload(void* mesh); // on main thread
+    void uploadBuffers();
     
     GLuint  m_texcoordOffset;
     GLuint  m_verticesOffset;
@@ -34,6 +37,13 @@ private:
     GLenum  m_mode;
     GLsizei m_indicesCount;
     bool    m_indexed;
+    bool    m_hasNormals; // face meshes have none, callers disable normal array
+};
+
+class FaceMesh : public Mesh
+{
+public:
+    FaceMesh(const Face& face);
 };
 
 class CubeMesh : public Mesh
@@ -16,7 +16,9 @@ Message::Message(const string&         message,
     m_position(position),
     m_color(color),
     m_align(align),
-    m_fontSize(fontSize)
+    m_fontSize(fontSize),
+    m_layout(),
+    m_layoutFont(NULL)
 {
 }
 
@@ -25,6 +27,16 @@ string Message::getText() const
     return m_text;
 }
 
+const TextLayout& Message::getLayout(const Font* font) const
+{
+    if (m_layoutFont != font)
+    {
+        m_layout = font->getLayout(getText());
+        m_layoutFont = font;
+    }
+    return m_layout;
+}
+
 void Message::applyFlow(float delta)
 {
 }
@@ -41,7 +53,7 @@ void Message::render(const Font* font) const
         glPushMatrix();
         glTranslatef(m_position.x, m_position.y, m_position.z);
         glColor4fv(m_color.v);
-        font->render(getText(), m_align);
+        font->render(getLayout(font), m_align);
         glPopMatrix();
     }
 }
@@ -128,6 +140,15 @@ ScoreMessage::ScoreMessage(const string&   message,
 {
 }
 
+void ScoreMessage::setScore(int score)
+{
+    if (m_score != score)
+    {
+        m_score = score;
+        invalidateLayout();
+    }
+}
+
 string ScoreMessage::getText() const
 {
     return Formatter(m_text)(m_score);
@@ -156,7 +177,11 @@ bool ComboMessage::applyDelta(float delta)
     if (m_points > 1)
     {
         m_color.w = 1.0f;
-        m_previousPoints = m_points;
+        if (m_previousPoints != m_points)
+        {
+            m_previousPoints = m_points;
+            invalidateLayout();
+        }
     }
     else
     {
@@ -202,7 +227,11 @@ bool LastTouchedMessage::applyDelta(float delta)
 
 void LastTouchedMessage::setMessage(const string& message, const Vector& color)
 {
-    m_text = message;
+    if (m_text != message)
+    {
+        m_text = message;
+        invalidateLayout();
+    }
     m_color = color;
     m_fadeOut = false;
 }
@@ -4,11 +4,12 @@
 #include "common.h"
 #include "font.h"
 #include "vmath.h"
+#include "object_pool.h"
 
 class Messages;
 class Font;
 
-class Message : public NoCopy
+class Message : public NoCopy, public Pooled<MemoryBudget::UI>
 {
     friend class Messages;
 public:
@@ -24,8 +25,14 @@ public:
 
     virtual string getText() const;
     virtual int     getFontSize() const { return m_fontSize; }
+
+    // layout is kept until text changes
+    const TextLayout& getLayout(const Font* font) const;
+    int getWidth(const Font* font) const { return getLayout(font).width; }
+    int getHeight(const Font* font) const { return getLayout(font).height; }
     
 protected:
+    void invalidateLayout() { m_layoutFont = NULL; }
    
     virtual void applyFlow(float delta);
 
@@ -38,6 +45,10 @@ protected:
     Vector          m_color;
     Font::AlignType m_align;
     int             m_fontSize;
+
+private:
+    mutable TextLayout  m_layout;
+    mutable const Font* m_layoutFont;
 };
 
 class BlinkingMessage : public Message
@@ -92,9 +103,10 @@ public:
         Font::AlignType align = Font::Align_Left);
     virtual ~ScoreMessage() {}
 
-    int m_score;
+    void setScore(int score);
 
 protected:
+    int m_score;
 
     string getText() const;
 };
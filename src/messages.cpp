@@ -15,25 +15,26 @@ void Messages::update(float delta)
 {
     for each_(MessageVectorsByHeight, m_buffer, iter)
     {
-        MessageVector* currentHeightbuffer = &iter->second;
-        MessageVector::iterator iter2 = currentHeightbuffer->begin();
+        // finished messages are deleted and rest is compacted in place
+        MessageVector& currentHeightbuffer = iter->second;
+        size_t kept = 0;
 
-        while (iter2 != currentHeightbuffer->end())
+        for (size_t i = 0; i < currentHeightbuffer.size(); i++)
         {
-            Message* message = *iter2;
+            Message* message = currentHeightbuffer[i];
 
             message->applyFlow(delta);
 
             if (message->applyDelta(delta))
             {
                 delete message;
-                iter2 = currentHeightbuffer->erase(iter2);
             }
             else
             {
-                iter2++;
+                currentHeightbuffer[kept++] = message;
             }
         }
+        currentHeightbuffer.resize(kept);
     }
 }
 
@@ -78,23 +79,26 @@ void Messages::add3D(Message* message)
         m, p, (GLint*)viewport,
         &vx, &vy, &vz);
 
+    const int width = message->getWidth(font);
+    const int height = message->getHeight(font);
+
     //correct positions to fit on screen
-    if (vx < font->getWidth(message->getText()) / 2)
+    if (vx < width / 2)
     {
-        vx = font->getWidth(message->getText()) / 2;
+        vx = width / 2;
     }
-    else if (vx > Video::instance->getResolution().first - font->getWidth(message->getText()) / 2)
+    else if (vx > Video::instance->getResolution().first - width / 2)
     {
-        vx = Video::instance->getResolution().first - font->getWidth(message->getText()) / 2;
+        vx = Video::instance->getResolution().first - width / 2;
     }
 
     if (vy < 0)
     {
         vy = 0;
     }
-    else if (vy > Video::instance->getResolution().second - font->getHeight(message->getText()) * 5)
+    else if (vy > Video::instance->getResolution().second - height * 5)
     {
-        vy = Video::instance->getResolution().second - font->getHeight(message->getText()) * 5;
+        vy = Video::instance->getResolution().second - height * 5;
     }
 
     message->m_position = Vector(static_cast<float>(vx),
@@ -128,7 +132,7 @@ Messages::~Messages()
 {
     for each_const(MessageVectorsByHeight, m_buffer, iter)
     {
-        MessageVector currentHeightbuffer = iter->second;
+        const MessageVector& currentHeightbuffer = iter->second;
         for each_const(MessageVector, currentHeightbuffer, iter2)
         {
             delete *iter2;    
@@ -8,7 +8,7 @@
 class Messages;
 class Message;
 
-typedef list<Message*> MessageVector;
+typedef vector<Message*> MessageVector;
 typedef map<int, MessageVector> MessageVectorsByHeight;
 typedef map<int, const Font*> Fonts;
 
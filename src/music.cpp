@@ -2,8 +2,19 @@
 
 #include "music.h"
 #include "config.h"
-
-Music::Music(const string& filename) : OggDecoder("/data/music/" + filename + ".ogg")
+#include "ring_buffer.h"
+#include "memory_budget.h"
+
+// how many 250ms buffers audio thread decodes ahead
+static const int DECODE_AHEAD = 8;
+
+Music::Music(const string& filename) : OggDecoder("/data/music/" + filename + ".ogg"),
+    m_freeCount(0),
+    m_decoded(NULL),
+    m_decodeBuffer(NULL),
+    m_finished(false),
+    m_looping(true),
+    m_playing(false)
 {
     // m_bufferSize is for 250ms
 
@@ -19,6 +30,9 @@ Music::Music(const string& filename) : OggDecoder("/data/music/" + filename + ".
     }
 
     m_buffer = new char [m_bufferSize];
+    m_decodeBuffer = new char [m_bufferSize];
+    m_decoded = new RingBuffer(DECODE_AHEAD * m_bufferSize);
+    MemoryBudget::add(MemoryBudget::Audio, memory());
 
     alGenBuffers(BUFFER_COUNT, m_buffers);
     alGenSources(1, &m_source);
@@ -36,6 +50,10 @@ void Music::init()
             alBufferData(m_buffers[i], m_format, m_buffer, static_cast<int>(written), m_frequency);
             alSourceQueueBuffers(m_source, 1, &m_buffers[i]);
         }
+        else
+        {
+            m_freeBuffers[m_freeCount++] = m_buffers[i];
+        }
     }
     m_position = 0.0f;
     alSourcef(m_source, AL_GAIN, 0);
@@ -47,6 +65,15 @@ Music::~Music()
     alDeleteBuffers(BUFFER_COUNT, m_buffers);
     alDeleteSources(1, &m_source);
     delete [] m_buffer;
+    delete [] m_decodeBuffer;
+    delete m_decoded;
+    MemoryBudget::remove(MemoryBudget::Audio, memory());
+}
+
+size_t Music::memory() const
+{
+    // m_buffer, m_decodeBuffer, m_decoded and OpenAL buffers
+    return (2 + DECODE_AHEAD + BUFFER_COUNT) * m_bufferSize;
 }
 
 void Music::play(bool looping)
@@ -56,45 +83,69 @@ void Music::play(bool looping)
         alSourcePlay(m_source);
     }
     m_looping = looping;
+    m_playing = Config::instance->m_audio.enabled;
 }
 
 void Music::stop()
 {
     alSourceStop(m_source);
+    m_playing = false;
+}
+
+void Music::decodeAhead()
+{
+    while (!m_finished && m_decoded->writable() >= m_bufferSize)
+    {
+        size_t written = decode(m_decodeBuffer, m_bufferSize);
+        if (written == 0 && m_looping)
+        {
+            reset();
+            written = decode(m_decodeBuffer, m_bufferSize);
+        }
+        if (written == 0)
+        {
+            m_finished = true;
+            break;
+        }
+        m_decoded->write(m_decodeBuffer, written);
+    }
 }
 
 void Music::update()
 {
     int processed = 0;
     alGetSourcei(m_source, AL_BUFFERS_PROCESSED, &processed);
-    int p = processed;
 
     while (processed > 0)
     {
         unsigned int buffer = 0;
         alSourceUnqueueBuffers(m_source, 1, &buffer);
+        m_freeBuffers[m_freeCount++] = buffer;
 
         m_position += 0.25f;
 
-        size_t written = decode(m_buffer, m_bufferSize);
-        if (written == 0 && m_looping)
-        {
-            reset();
-            written = decode(m_buffer, m_bufferSize);
-        }
-        if (written > 0)
+        processed--;
+    }
+
+    // if audio thread is late, buffers wait for the next frame
+    while (m_freeCount > 0)
+    {
+        size_t available = m_decoded->readable();
+        if (available == 0 || (available < m_bufferSize && !m_finished))
         {
-            alBufferData(buffer, m_format, m_buffer, static_cast<int>(written), m_frequency);
-            alSourceQueueBuffers(m_source, 1, &buffer);
+            break;
         }
 
-        processed--;
+        size_t written = m_decoded->read(m_buffer, m_bufferSize);
+        unsigned int buffer = m_freeBuffers[--m_freeCount];
+        alBufferData(buffer, m_format, m_buffer, static_cast<int>(written), m_frequency);
+        alSourceQueueBuffers(m_source, 1, &buffer);
     }
     
     int state;
     alGetSourcei(m_source, AL_SOURCE_STATE, &state);
     
-    if (p != 0 && state == AL_STOPPED)
+    if (m_playing && state == AL_STOPPED && m_freeCount < BUFFER_COUNT)
     {
         alSourcePlay(m_source);
     }
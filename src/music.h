@@ -4,6 +4,8 @@
 #include "common.h"
 #include "oggDecoder.h"
 
+class RingBuffer;
+
 static const int BUFFER_COUNT = 4;
 
 class Music : public OggDecoder
@@ -20,15 +22,25 @@ private:
 
     unsigned int m_source;
     unsigned int m_buffers[BUFFER_COUNT];
+    unsigned int m_freeBuffers[BUFFER_COUNT];
+    int m_freeCount;
     char* m_buffer;
     size_t m_bufferSize;
 
+    // filled by audio thread, emptied by main thread
+    RingBuffer* m_decoded;
+    char* m_decodeBuffer;
+    volatile bool m_finished;
+
     float m_position;
 
-    bool m_looping;
+    volatile bool m_looping; // read by audio thread
+    bool m_playing;
 
-    void update();
+    void update();      // main thread, only requeues OpenAL buffers
+    void decodeAhead(); // audio thread
     void init();
+    size_t memory() const;
 };
 
 #endif
@@ -17,9 +17,30 @@
 #include "config.h"
 #include "chat.h"
 #include "xml.h"
+#include "memory_budget.h"
 
 template <class Network> Network* System<Network>::instance = NULL;
 
+// ENet frees without size, so it is stored before each block
+static const size_t ENET_HEADER = 16; // keeps alignment of returned memory
+
+static void* ENET_CALLBACK enetAlloc(size_t size)
+{
+    char* block = static_cast<char*>(MemoryBudget::allocate(MemoryBudget::Network, size + ENET_HEADER));
+    *reinterpret_cast<size_t*>(block) = size + ENET_HEADER;
+    return block + ENET_HEADER;
+}
+
+static void ENET_CALLBACK enetFree(void* ptr)
+{
+    if (ptr == NULL)
+    {
+        return;
+    }
+    char* block = static_cast<char*>(ptr) - ENET_HEADER;
+    MemoryBudget::release(MemoryBudget::Network, block, *reinterpret_cast<size_t*>(block));
+}
+
 Network::Network() :
     m_needDisconnect(false),
     m_disconnected(false),
@@ -31,6 +52,7 @@ Network::Network() :
     m_menu(NULL),
     m_tmpProfile(NULL),
     m_ready_count(0),
+    m_packetsMemory(0),
     m_needToStartGame(false),
     m_needToBeginGame(false),
     m_needToQuitGame(false),
@@ -40,7 +62,9 @@ Network::Network() :
 {
     clog << "Initializing network." << endl;
 
-    if (enet_initialize() != 0)
+    // hosts, peers and their queues are counted to network budget
+    ENetCallbacks callbacks = { enetAlloc, enetFree, NULL };
+    if (enet_initialize_with_callbacks(ENET_VERSION, &callbacks) != 0)
     {
         throw Exception("enet_initialize failed");
     }
@@ -188,11 +212,9 @@ void Network::close()
     }
     m_activeBodies.clear();
 
-    for each_const(PacketBuffer, m_packetsBuffer, iter)
-    {
-        delete *iter;
-    }
-    m_packetsBuffer.clear();
+    bytes().swap(m_packetsBuffer);
+    vector<size_t>().swap(m_packetsEnds);
+    updatePacketsMemory();
 
     for each_const(set<Profile*>, m_garbage, iter)
     {
@@ -251,22 +273,31 @@ void Network::update()
             {
                 sendUpdatePacket();
 
-                for each_const(PacketBuffer, m_packetsBuffer, iter)
+                size_t begin = 0;
+                for each_const(vector<size_t>, m_packetsEnds, iter)
                 {
                     for each_const(PlayerMap, m_clients, client)
                     {
-                        send(client->first, **iter, true);
+                        send(client->first, &m_packetsBuffer[begin], *iter - begin, true);
                     }
-                    delete *iter;
+                    begin = *iter;
                 }
                 m_packetsBuffer.clear();
+                m_packetsEnds.clear();
             }
             else // client
             {
-                ControlPacket* packet = m_players[m_localIdx]->getControl(m_localIdx);
-                if (packet != NULL)
+                // only server sends game events
+                m_packetsBuffer.clear();
+                m_packetsEnds.clear();
+
+                Vector direction, rotation;
+                bool jump = false, kick = false;
+                if (m_players[m_localIdx]->getControl(direction, rotation, jump, kick))
                 {
-                    send(m_server, *packet, false);
+                    // packet data is in frame memory, so it must not outlive this frame
+                    ControlPacket packet(static_cast<byte>(m_localIdx), direction, rotation, jump, kick);
+                    send(m_server, packet, false);
                 }
             }
             
@@ -379,7 +410,7 @@ void Network::update()
 
         case ENET_EVENT_TYPE_RECEIVE:
             type = "Recieve"; // peer, channelID, packer (must destroy)
-            processPacket(event.peer, bytes(event.packet->data, event.packet->data + event.packet->dataLength));
+            processPacket(event.peer, PacketBytes(event.packet->data, event.packet->data + event.packet->dataLength));
             enet_packet_destroy(event.packet);
             break;
         default:
@@ -436,6 +467,16 @@ void Network::setCpuProfiles(const vector<Profile*> profiles[], int level)
     }
 }
 
+void Network::setAiProfiles(const vector<Profile*>& profiles)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        m_profiles[i] = profiles[i];
+        m_aiIdx[i] = true;
+    }
+    m_localIdx = -1;
+}
+
 Profile* Network::getRandomAI()
 {
     bool found = true;
@@ -553,9 +594,37 @@ bool Network::isLocal(int idx) const
     return idx == m_localIdx || m_aiIdx[idx];
 }
 
+void Network::queue(const Packet& packet)
+{
+    const PacketBytes& data = packet.data();
+    m_packetsBuffer.insert(m_packetsBuffer.end(), data.begin(), data.end());
+    m_packetsEnds.push_back(m_packetsBuffer.size());
+    updatePacketsMemory();
+}
+
+void Network::updatePacketsMemory()
+{
+    // queue keeps its capacity between updates, so only growth is reported
+    const size_t memory = m_packetsBuffer.capacity() + m_packetsEnds.capacity() * sizeof(size_t);
+    if (memory > m_packetsMemory)
+    {
+        MemoryBudget::add(MemoryBudget::Network, memory - m_packetsMemory);
+    }
+    else if (memory < m_packetsMemory)
+    {
+        MemoryBudget::remove(MemoryBudget::Network, m_packetsMemory - memory);
+    }
+    m_packetsMemory = memory;
+}
+
 void Network::send(ENetPeer* peer, const Packet& packet, bool important)
 {
-    ENetPacket* p = enet_packet_create(&packet.data()[0], packet.data().size(), (important ? ENET_PACKET_FLAG_RELIABLE : 0));
+    send(peer, &packet.data()[0], packet.data().size(), important);
+}
+
+void Network::send(ENetPeer* peer, const byte* data, size_t size, bool important)
+{
+    ENetPacket* p = enet_packet_create(data, size, (important ? ENET_PACKET_FLAG_RELIABLE : 0));
     enet_peer_send(peer, 0, p);
 }
 
@@ -597,14 +666,14 @@ void Network::addResetOwnComboPacket(const Body* body)
     int bodyIdx = getBodyIdx(body);
     if (bodyIdx != -1)
     {
-        m_packetsBuffer.push_back(new ComboResetOwnPacket(bodyIdx));
+        queue(ComboResetOwnPacket(bodyIdx));
     }
 }
 void Network::addResetComboPacket()
 {
     if (m_isSingle) return;
 
-    m_packetsBuffer.push_back(new ComboResetPacket());
+    queue(ComboResetPacket());
 }
 void Network::addIncrementComboPacket(const Body* body)
 {
@@ -613,7 +682,7 @@ void Network::addIncrementComboPacket(const Body* body)
     int bodyIdx = getBodyIdx(body);
     if (bodyIdx != -1)
     {
-        m_packetsBuffer.push_back(new ComboIncPacket(bodyIdx));
+        queue(ComboIncPacket(bodyIdx));
     }
 }
 
@@ -629,14 +698,16 @@ void Network::addRefereePacket(int faultID, const Body* body, int points)
     int bodyIdx = getBodyIdx(body);
     if (bodyIdx != -1)
     {
-        m_packetsBuffer.push_back(new RefereePacket(faultID, bodyIdx, points));
+        queue(RefereePacket(faultID, bodyIdx, points));
     }
 }
 
 void Network::addSoundPacket(byte id, const Vector& position)
 {
+    if (m_isSingle) return;
+
     //clog << "SERVER: sound, " << (int)id << endl;
-    m_packetsBuffer.push_back(new SoundPacket(id, position));
+    queue(SoundPacket(id, position));
 }
 
 void Network::addChatPacket(const string& msg)
@@ -658,7 +729,7 @@ void Network::addChatPacket(const string& msg)
         }
         else
         {
-            m_packetsBuffer.push_back(new ChatPacket(m_localIdx, msg));
+            queue(ChatPacket(m_localIdx, msg));
         }
     }
     else
@@ -667,7 +738,7 @@ void Network::addChatPacket(const string& msg)
     }
 }
 
-void Network::processPacket(ENetPeer* peer, const bytes& packet)
+void Network::processPacket(ENetPeer* peer, const PacketBytes& packet)
 {
     if (packet.size() < 1)
     {
@@ -15,12 +15,12 @@
 #include "timer.h"
 #include "system.h"
 #include "vmath.h"
+#include "packet.h"
 
 class Body;
 class Profile;
 class Level;
 class Player;
-class Packet;
 class Menu;
 class RefereeBase;
 class RemotePlayer;
@@ -40,8 +40,6 @@ typedef vector<ActiveBody*> ActiveBodyVector;
 
 typedef map<ENetPeer*, int> PlayerMap;
 
-typedef vector<const Packet*> PacketBuffer;
-
 class Network : public System<Network>, public NoCopy
 {
 public:
@@ -60,6 +58,7 @@ public:
 
     void setPlayerProfile(Profile* player);
     void setCpuProfiles(const vector<Profile*> profiles[], int level);
+    void setAiProfiles(const vector<Profile*>& profiles); // no local player
     void createRemoteProfiles();
     void setAiProfile(int idx, Profile* ai);
     Profile* getRandomAI();
@@ -135,7 +134,10 @@ private:
     Timer            m_timer;
     Timer            m_bodyTimer;
 
-    PacketBuffer     m_packetsBuffer;
+    // serialized packets for next update, packet data itself is in frame memory
+    bytes            m_packetsBuffer;
+    vector<size_t>   m_packetsEnds;
+    size_t           m_packetsMemory; // capacity counted to network budget
 
     RefereeBase*     m_referee;
     bool             m_clientReady[4];
@@ -143,8 +145,11 @@ private:
     float            m_netfps;
 
     void sendUpdatePacket();
+    void queue(const Packet& packet);
+    void updatePacketsMemory();
     void send(ENetPeer* peer, const Packet& packet, bool important);
-    void processPacket(ENetPeer* peer, const bytes& packet);
+    void send(ENetPeer* peer, const byte* data, size_t size, bool important);
+    void processPacket(ENetPeer* peer, const PacketBytes& packet);
 
     const OptionEntry* m_levelEntry;
     StringVector     m_levelFiles;
@@ -0,0 +1,138 @@
+#if defined(_MSC_VER)
+#include <intrin.h>
+#pragma intrinsic(_InterlockedExchange)
+#endif
+
+#include "object_pool.h"
+
+static const size_t GRANULARITY = 16;
+static const size_t MAX_BLOCK = 256; // bigger objects go to heap
+static const size_t BUCKETS = MAX_BLOCK / GRANULARITY;
+static const size_t CHUNK_BLOCKS = 32;
+
+struct FreeBlock
+{
+    FreeBlock* next;
+};
+
+struct Bucket
+{
+    FreeBlock*   free;
+    unsigned int live;
+};
+
+typedef vector<pair<void*, size_t> > Chunks;
+
+static Bucket buckets[MemoryBudget::TagCount][BUCKETS];
+static Chunks chunks[MemoryBudget::TagCount];
+
+// loader thread creates messages too, lock is held only for few instructions
+static volatile long locked = 0;
+
+class PoolLock : public NoCopy
+{
+public:
+    PoolLock()
+    {
+#if defined(_MSC_VER)
+        while (_InterlockedExchange(&locked, 1) != 0)
+#else
+        while (__sync_lock_test_and_set(&locked, 1) != 0)
+#endif
+        {
+        }
+    }
+
+    ~PoolLock()
+    {
+#if defined(_MSC_VER)
+        _InterlockedExchange(&locked, 0);
+#else
+        __sync_lock_release(&locked);
+#endif
+    }
+};
+
+static void refill(MemoryBudget::Tag tag, size_t index)
+{
+    const size_t blockSize = (index + 1) * GRANULARITY;
+    char* chunk = static_cast<char*>(MemoryBudget::allocate(tag, blockSize * CHUNK_BLOCKS));
+    chunks[tag].push_back(make_pair(static_cast<void*>(chunk), blockSize * CHUNK_BLOCKS));
+
+    // linked backwards, so blocks are handed out in address order
+    Bucket& bucket = buckets[tag][index];
+    for (size_t i = CHUNK_BLOCKS; i > 0; i--)
+    {
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + (i - 1) * blockSize);
+        block->next = bucket.free;
+        bucket.free = block;
+    }
+}
+
+void* ObjectPool::allocate(MemoryBudget::Tag tag, size_t size)
+{
+    if (size > MAX_BLOCK)
+    {
+        return MemoryBudget::allocate(tag, size);
+    }
+
+    const size_t index = (size - 1) / GRANULARITY;
+
+    PoolLock lock;
+    Bucket& bucket = buckets[tag][index];
+    if (bucket.free == NULL)
+    {
+        refill(tag, index);
+    }
+
+    FreeBlock* block = bucket.free;
+    bucket.free = block->next;
+    bucket.live++;
+    return block;
+}
+
+void ObjectPool::release(MemoryBudget::Tag tag, void* ptr, size_t size)
+{
+    if (ptr == NULL)
+    {
+        return;
+    }
+    if (size > MAX_BLOCK)
+    {
+        MemoryBudget::release(tag, ptr, size);
+        return;
+    }
+
+    PoolLock lock;
+    Bucket& bucket = buckets[tag][(size - 1) / GRANULARITY];
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    block->next = bucket.free;
+    bucket.free = block;
+    bucket.live--;
+}
+
+void ObjectPool::clear()
+{
+    PoolLock lock;
+    for (int tag = 0; tag < MemoryBudget::TagCount; tag++)
+    {
+        unsigned int live = 0;
+        for (size_t i = 0; i < BUCKETS; i++)
+        {
+            live += buckets[tag][i].live;
+            buckets[tag][i].free = NULL;
+            buckets[tag][i].live = 0;
+        }
+        if (live != 0)
+        {
+            clog << "ObjectPool: " << live << " " << MemoryBudget::name(static_cast<MemoryBudget::Tag>(tag))
+                 << " objects were not deleted" << endl;
+        }
+
+        for each_const(Chunks, chunks[tag], iter)
+        {
+            MemoryBudget::release(static_cast<MemoryBudget::Tag>(tag), iter->first, iter->second);
+        }
+        chunks[tag].clear();
+    }
+}
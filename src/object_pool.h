@@ -0,0 +1,38 @@
+#ifndef __OBJECT_POOL_H__
+#define __OBJECT_POOL_H__
+
+#include "common.h"
+#include "memory_budget.h"
+
+// small objects that are created and deleted all the time (messages,
+// packets) are taken from chunks of same sized blocks, deleted blocks
+// are kept in intrusive free list for their size, so after warm up
+// gameplay does not touch general heap; chunks are counted to tag
+class ObjectPool
+{
+public:
+    static void* allocate(MemoryBudget::Tag tag, size_t size);
+    static void release(MemoryBudget::Tag tag, void* ptr, size_t size);
+
+    // frees all chunks, at exit after all pooled objects are deleted
+    static void clear();
+};
+
+// objects of classes derived from this are allocated from pool,
+// sized delete gets size of most derived class if destructor is virtual
+template <MemoryBudget::Tag tag>
+class Pooled
+{
+public:
+    static void* operator new(size_t size)
+    {
+        return ObjectPool::allocate(tag, size);
+    }
+
+    static void operator delete(void* ptr, size_t size)
+    {
+        ObjectPool::release(tag, ptr, size);
+    }
+};
+
+#endif
@@ -1,3 +1,4 @@
+#include <cstring>
 #include "openal_includes.h"
 
 #include "oggDecoder.h"
@@ -32,15 +33,84 @@ static long ov_tell_func(void *datasource)
 
 static const ov_callbacks oggCallbacks = { ov_read_func, ov_seek_func, ov_close_func, ov_tell_func };
 
+// memory mapped source, no copying through PhysicsFS and zlib
 
-OggDecoder::OggDecoder(const string& filename) : m_file(File::Reader(filename))
+static size_t mem_read_func(void* ptr, size_t size, size_t nmemb, void* datasource)
 {
-    if (!m_file.is_open())
+    OggDecoder::Memory* memory = static_cast<OggDecoder::Memory*>(datasource);
+    size_t count = std::min(nmemb, (memory->size - memory->position) / size);
+    memcpy(ptr, memory->data + memory->position, count * size);
+    memory->position += count * size;
+    return count;
+}
+
+static int mem_seek_func(void *datasource, ogg_int64_t offset, int whence)
+{
+    OggDecoder::Memory* memory = static_cast<OggDecoder::Memory*>(datasource);
+    ogg_int64_t position;
+    if (whence == SEEK_CUR)
+    {
+        position = memory->position + offset;
+    }
+    else if (whence == SEEK_END)
     {
-        throw Exception("File '" + filename + "' not found");
+        position = memory->size + offset;
     }
+    else // SEEK_SET
+    {
+        position = offset;
+    }
+
+    if (position < 0 || position > static_cast<ogg_int64_t>(memory->size))
+    {
+        return -1;
+    }
+    memory->position = static_cast<size_t>(position);
+    return 0;
+}
+
+static long mem_tell_func(void *datasource)
+{
+    OggDecoder::Memory* memory = static_cast<OggDecoder::Memory*>(datasource);
+    return static_cast<long>(memory->position);
+}
+
+static const ov_callbacks memoryCallbacks = { mem_read_func, mem_seek_func, ov_close_func, mem_tell_func };
+
+// 4KB PhysicsFS default refills zlib too often while streaming
+static const size_t DEFAULT_READ_AHEAD = 64 * 1024;
 
-    int result = ov_open_callbacks(static_cast<void*>(&m_file), &m_oggFile, NULL, 0, oggCallbacks);
+size_t OggDecoder::m_readAhead = DEFAULT_READ_AHEAD;
+
+void OggDecoder::setReadAhead(size_t bytes)
+{
+    m_readAhead = bytes;
+}
+
+OggDecoder::Memory::Memory(const string& filename) : data(NULL), size(0), position(0)
+{
+    File::mapView(filename, data, size);
+}
+
+OggDecoder::OggDecoder(const string& filename) :
+    m_memory(filename),
+    m_file(m_memory.data == NULL ? filename : string())
+{
+    int result;
+    if (m_memory.data != NULL)
+    {
+        result = ov_open_callbacks(static_cast<void*>(&m_memory), &m_oggFile, NULL, 0, memoryCallbacks);
+    }
+    else
+    {
+        if (!m_file.is_open())
+        {
+            throw Exception("File '" + filename + "' not found");
+        }
+        m_file.setBuffer(m_readAhead);
+
+        result = ov_open_callbacks(static_cast<void*>(&m_file), &m_oggFile, NULL, 0, oggCallbacks);
+    }
     if (result != 0)
     {
         switch (result)
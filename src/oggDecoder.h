@@ -13,6 +13,18 @@ public:
 
     void reset();
 
+    // PhysicsFS buffer for compressed files, packed and stored files are memory mapped
+    static void setReadAhead(size_t bytes);
+
+    struct Memory
+    {
+        Memory(const string& filename);
+
+        const char* data;
+        size_t      size;
+        size_t      position;
+    };
+
 protected:
     unsigned int m_frequency;
     unsigned int m_channels;
@@ -22,6 +34,9 @@ protected:
     size_t decode(char* buffer, const size_t bufferSize);
 
 private:
+    static size_t m_readAhead;
+
+    Memory m_memory; // must be before m_file
     File::Reader m_file;
     OggVorbis_File m_oggFile;
 
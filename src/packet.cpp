@@ -3,15 +3,19 @@
 #include "body.h"
 #include "version.h"
 
+// most packets fit, so frame memory is not wasted on growing
+static const size_t PACKET_RESERVE = 32;
+
 Packet::Packet(int type) :
     m_data(),
     m_pos(0),
     m_size(0)
 {
+    m_data.reserve(PACKET_RESERVE);
     writeByte(type);
 }
 
-Packet::Packet(const bytes& data) :
+Packet::Packet(const PacketBytes& data) :
     m_data(data),
     m_size(data.size()),
     m_pos(1) // skip type
@@ -114,28 +118,24 @@ void Packet::writeFloat(float x)
 
 void Packet::writeString(const string& x)
 {
-    string xx = x;
-    if (x.size() > 255)
+    size_t length = x.size();
+    if (length > 255)
     {
         clog << "Network packet warning: " << Exception("x.size() > 255") << endl;
-        xx = x.substr(0, 255);
+        length = 255;
     }
-    m_data.push_back(static_cast<byte>(xx.size()));
+    m_data.push_back(static_cast<byte>(length));
     m_size++;
-    m_data.resize(m_size+xx.size());
-    for (size_t i=0; i<xx.size(); i++)
-    {
-        m_data[m_size + i] = xx[i];
-    }
-    m_size += xx.size();
+    m_data.insert(m_data.end(), x.begin(), x.begin() + length);
+    m_size += length;
 }
 
-const bytes& Packet::data() const
+const PacketBytes& Packet::data() const
 {
     return m_data;
 }
 
-ControlPacket::ControlPacket(const bytes& data) : Packet(data)
+ControlPacket::ControlPacket(const PacketBytes& data) : Packet(data)
 {
     m_netDirection.x = readShort()/512.0f;
     m_netDirection.y = readShort()/512.0f;
@@ -163,7 +163,7 @@ ControlPacket::ControlPacket(byte idx, const Vector& direction, const Vector& ro
     writeByte(idxJumpKick);
 }
 
-JoinPacket::JoinPacket(const bytes& data) : Packet(data), m_profile(NULL)
+JoinPacket::JoinPacket(const PacketBytes& data) : Packet(data), m_profile(NULL)
 {
     m_idx = readInt();
     m_version = readString();
@@ -186,7 +186,7 @@ RefereePacket::RefereePacket(int faultID, int bodyID, int points) : Packet(ID_RE
     writeByte(static_cast<byte>(points));
 }
 
-RefereePacket::RefereePacket(const bytes& data) : Packet(data)
+RefereePacket::RefereePacket(const PacketBytes& data) : Packet(data)
 {
 	byte faultIDbodyID = readByte();
     m_faultID = faultIDbodyID >> 4;
@@ -199,7 +199,7 @@ ComboIncPacket::ComboIncPacket(int bodyID) : Packet(ID_INCCOMBO)
     writeByte(static_cast<byte>(bodyID));
 }
 
-ComboIncPacket::ComboIncPacket(const bytes& data) : Packet(data)
+ComboIncPacket::ComboIncPacket(const PacketBytes& data) : Packet(data)
 {
     m_bodyID = static_cast<int>(readByte());
 }
@@ -210,7 +210,7 @@ ComboResetOwnPacket::ComboResetOwnPacket(int bodyID) :
     writeByte(static_cast<byte>(bodyID));
 }
 
-ComboResetOwnPacket::ComboResetOwnPacket(const bytes& data) : Packet(data)
+ComboResetOwnPacket::ComboResetOwnPacket(const PacketBytes& data) : Packet(data)
 {
     m_bodyID = static_cast<int>(readByte());
 }
@@ -219,7 +219,7 @@ ComboResetPacket::ComboResetPacket() : Packet(ID_RESETCOMBO)
 {
 }
 
-ComboResetPacket::ComboResetPacket(const bytes& data) : Packet(data)
+ComboResetPacket::ComboResetPacket(const PacketBytes& data) : Packet(data)
 {
 }
 
@@ -245,7 +245,7 @@ JoinPacket::~JoinPacket()
     }
 }
 
-KickPacket::KickPacket(const bytes& data) : Packet(data)
+KickPacket::KickPacket(const PacketBytes& data) : Packet(data)
 {
     m_reason = readString();
 }
@@ -255,7 +255,7 @@ KickPacket::KickPacket(const string& reason) : Packet(ID_KICK)
     writeString(reason);
 }
 
-KickNamesPacket::KickNamesPacket(const bytes& data) : Packet(data)
+KickNamesPacket::KickNamesPacket(const PacketBytes& data) : Packet(data)
 {
 }
 
@@ -263,7 +263,7 @@ KickPlacesPacket::KickPlacesPacket() : Packet(ID_KICKPLACES)
 {
 }
 
-KickPlacesPacket::KickPlacesPacket(const bytes& data) : Packet(data)
+KickPlacesPacket::KickPlacesPacket(const PacketBytes& data) : Packet(data)
 {
 }
 
@@ -271,7 +271,7 @@ KickNamesPacket::KickNamesPacket() : Packet(ID_KICKNAME)
 {
 }
 
-SetPlacePacket::SetPlacePacket(const bytes& data) : Packet(data)
+SetPlacePacket::SetPlacePacket(const PacketBytes& data) : Packet(data)
 {
     m_idx = readByte();
     m_level = readByte();
@@ -283,7 +283,7 @@ SetPlacePacket::SetPlacePacket(int idx, byte level) : Packet(ID_PLACE)
     writeByte(level);
 }
 
-QuitPacket::QuitPacket(const bytes& data) : Packet(data)
+QuitPacket::QuitPacket(const PacketBytes& data) : Packet(data)
 {
 }
 
@@ -291,7 +291,7 @@ QuitPacket::QuitPacket() : Packet(ID_QUIT)
 {
 }
 
-StartPacket::StartPacket(const bytes& data) : Packet(data)
+StartPacket::StartPacket(const PacketBytes& data) : Packet(data)
 {
 }
 
@@ -299,7 +299,7 @@ StartPacket::StartPacket() : Packet(ID_START)
 {
 }
 
-ReadyPacket::ReadyPacket(const bytes& data) : Packet(data)
+ReadyPacket::ReadyPacket(const PacketBytes& data) : Packet(data)
 {
 }
 
@@ -307,7 +307,7 @@ ReadyPacket::ReadyPacket() : Packet(ID_READY)
 {
 }
 
-UpdatePacket::UpdatePacket(const bytes& data) : Packet(data)
+UpdatePacket::UpdatePacket(const PacketBytes& data) : Packet(data)
 {
     m_idx = readByte();
 
@@ -338,7 +338,7 @@ UpdatePacket::UpdatePacket(byte idx, const Body* body) : Packet(ID_UPDATE)
     writeShort(static_cast<short>(std::floor(m_position[14]*512.0f)));
 }
 
-SoundPacket::SoundPacket(const bytes& data) : Packet(data)
+SoundPacket::SoundPacket(const PacketBytes& data) : Packet(data)
 {
     m_id = readByte();
     m_position.x = readShort()*512.0f;
@@ -354,7 +354,7 @@ SoundPacket::SoundPacket(byte id, const Vector& position) : Packet(ID_SOUND)
     writeShort(static_cast<short>(std::floor(position.z*512.0f)));
 }
 
-ChatPacket::ChatPacket(const bytes& data) : Packet(data)
+ChatPacket::ChatPacket(const PacketBytes& data) : Packet(data)
 {
     m_player = readByte();
     m_msg = readString();
@@ -3,10 +3,15 @@
 
 #include "common.h"
 #include "vmath.h"
+#include "frame_allocator.h"
 
 class Profile;
 class Body;
 
+// packet data is serialized to frame memory, packets that must be kept
+// longer are copied out (Network::queue)
+typedef vector<byte, FrameAlloc<byte> > PacketBytes;
+
 class Packet : public NoCopy
 {
 public:
@@ -34,12 +39,12 @@ public:
         ID_RESETOWNCOMBO = 16,
     };
 
-    const bytes& data() const;
+    const PacketBytes& data() const;
     virtual ~Packet() {}
 
 protected:
     Packet(int type);
-    Packet(const bytes& data);
+    Packet(const PacketBytes& data);
 
     byte   readByte();
     short  readShort();
@@ -54,7 +59,7 @@ protected:
     void writeString(const string& x);
 
 private:
-    bytes  m_data;
+    PacketBytes m_data;
     size_t m_pos;
     size_t m_size;
 };
@@ -62,7 +67,7 @@ private:
 class ControlPacket : public Packet
 {
 public:
-    ControlPacket(const bytes& data);
+    ControlPacket(const PacketBytes& data);
     ControlPacket(byte idx, const Vector& direction, const Vector& rotation, bool jump, bool kick);
 
     Vector m_netDirection;
@@ -75,7 +80,7 @@ public:
 class UpdatePacket : public Packet
 {
 public:
-    UpdatePacket(const bytes& data);
+    UpdatePacket(const PacketBytes& data);
     UpdatePacket(byte idx, const Body* body);
 
     Matrix m_position;
@@ -85,7 +90,7 @@ public:
 class RefereePacket : public Packet
 {
 public:
-    RefereePacket(const bytes& data);
+    RefereePacket(const PacketBytes& data);
     RefereePacket(int faultID, int bodyID, int points);
 
     int m_faultID;
@@ -96,7 +101,7 @@ public:
 class ComboIncPacket : public Packet
 {
 public:
-    ComboIncPacket(const bytes& data);
+    ComboIncPacket(const PacketBytes& data);
     ComboIncPacket(int bodyID);
 
     int m_bodyID;
@@ -105,7 +110,7 @@ public:
 class ComboResetOwnPacket : public Packet
 {
 public:
-    ComboResetOwnPacket(const bytes& data);
+    ComboResetOwnPacket(const PacketBytes& data);
     ComboResetOwnPacket(int bodyID);
 
     int m_bodyID;
@@ -114,14 +119,14 @@ public:
 class ComboResetPacket : public Packet
 {
 public:
-    ComboResetPacket(const bytes& data);
+    ComboResetPacket(const PacketBytes& data);
     ComboResetPacket();
 };
 
 class JoinPacket : public Packet
 {
 public:
-    JoinPacket(const bytes& data);
+    JoinPacket(const PacketBytes& data);
     JoinPacket(int idx, const string& version, Profile* profile);
     ~JoinPacket();
 
@@ -133,7 +138,7 @@ public:
 class KickPacket : public Packet
 {
 public:
-    KickPacket(const bytes& data);
+    KickPacket(const PacketBytes& data);
     KickPacket(const string& reason);
 
     string m_reason;
@@ -142,21 +147,21 @@ public:
 class KickNamesPacket : public Packet
 {
 public:
-    KickNamesPacket(const bytes& data);
+    KickNamesPacket(const PacketBytes& data);
     KickNamesPacket();
 };
 
 class KickPlacesPacket : public Packet
 {
 public:
-    KickPlacesPacket(const bytes& data);
+    KickPlacesPacket(const PacketBytes& data);
     KickPlacesPacket();
 };
 
 class SetPlacePacket : public Packet
 {
 public:
-    SetPlacePacket(const bytes& data);
+    SetPlacePacket(const PacketBytes& data);
     SetPlacePacket(int idx, byte level);
 
     int m_idx;
@@ -166,28 +171,28 @@ public:
 class QuitPacket : public Packet
 {
 public:
-    QuitPacket(const bytes& data);
+    QuitPacket(const PacketBytes& data);
     QuitPacket();
 };
 
 class StartPacket : public Packet
 {
 public:
-    StartPacket(const bytes& data);
+    StartPacket(const PacketBytes& data);
     StartPacket();
 };
 
 class ReadyPacket : public Packet
 {
 public:
-    ReadyPacket(const bytes& data);
+    ReadyPacket(const PacketBytes& data);
     ReadyPacket();
 };
 
 class SoundPacket : public Packet
 {
 public:
-    SoundPacket(const bytes& data);
+    SoundPacket(const PacketBytes& data);
     SoundPacket(byte id, const Vector& position);
 
     byte   m_id;
@@ -197,7 +202,7 @@ public:
 class ChatPacket : public Packet
 {
 public:
-    ChatPacket(const bytes& data);
+    ChatPacket(const PacketBytes& data);
     ChatPacket(byte player, const string& msg);
 
     byte   m_player;
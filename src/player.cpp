@@ -37,7 +37,7 @@ Player::Player(const Profile* profile, Level* level) :
     m_jump(false),
     m_halt(false),
     m_levelCollision(level->getCollision("level")),
-    m_ballBody(level->getBody("football")),
+    m_ballBody(level->m_football),
     m_packet(NULL)
 {
     CollisionSet collisions;
@@ -100,7 +100,7 @@ void Player::setKick(bool needKick)
         if ( m_timer.read() > 0.4f && dist.magnitude2() < (0.2f+BALL_RADIUS+m_radius)*(0.2f+BALL_RADIUS+m_radius) ) // TODO: (gurkja resnums + bumbas_raadiuss)^2
         {
             Properties* prop = World::instance->m_level->m_properties;
-            const pair<byte, SoundBuffer*>* sb = prop->getSB(prop->getPropertyID("player"), prop->getPropertyID("football"));
+            const pair<byte, SoundBuffer*>* sb = prop->getSB(prop->getPlayer(), prop->getFootball());
             prop->play(m_body, sb, true, m_ballBody->getPosition());
             Network::instance->addSoundPacket(sb->first, m_ballBody->getPosition());
 
@@ -207,11 +207,11 @@ void Player::renderColor() const
 {
     Vector c(m_profile->m_color);
     c.w = 0.3f;
-    Video::instance->renderSimpleShadow(0.3f, m_body->getPosition(), m_levelCollision, c);
+    Video::instance->addSimpleShadow(this, 0.3f, m_body->getPosition(), m_levelCollision, c);
 }
 
-ControlPacket* Player::getControl(int idx)
+bool Player::getControl(Vector& direction, Vector& rotation, bool& jump, bool& kick) const
 {
     assert(false);
-    return NULL;
+    return false;
 }
@@ -31,7 +31,8 @@ public:
 
     virtual void control() = 0;
     virtual void control(const ControlPacket& packet) = 0;
-    virtual ControlPacket* getControl(int idx);
+    // latest input to send to server, false if there is none
+    virtual bool getControl(Vector& direction, Vector& rotation, bool& jump, bool& kick) const;
 
     Vector getPosition() const;
     Vector getFieldCenter() const;
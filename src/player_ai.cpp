@@ -1,3 +1,5 @@
+#include <cmath>
+
 #include "player_ai.h"
 #include "input.h"
 #include "world.h"
@@ -5,9 +7,28 @@
 #include "random.h"
 #include "geometry.h"
 #include "level.h"
+#include "collision.h"
+#include "profile.h"
+#include "ball.h"
+
+static const float PREDICT_TIME = 3.0f;
+static const float PREDICT_STEP = 0.02f;
+// ball is reachable below this height
+static const float PREDICT_REACH = 1.0f;
+// how much ball velocity may differ from predicted before predicting again
+static const float PREDICT_TOLERANCE = 0.5f;
+static const float BOUNCE_RESTITUTION = 0.6f;
+static const float BOUNCE_FRICTION = 0.8f;
 
 AiPlayer::AiPlayer(const Profile* profile, Level* level) :
-    Player(profile, level)
+    Player(profile, level),
+    m_predict(profile->m_predict),
+    m_gravity(level->m_gravity),
+    m_predictTimer(),
+    m_predictVelocity(),
+    m_predictBounce(0.0f),
+    m_predictFound(false),
+    m_predictTarget()
 {
 }
 
@@ -27,9 +48,65 @@ AiPlayer::~AiPlayer()
 {
 }
 
+float AiPlayer::getGroundHeight(float x, float z) const
+{
+    if (std::abs(x) < FIELD_LENGTH && std::abs(z) < FIELD_LENGTH)
+    {
+        return 0.0f;
+    }
+    return m_levelCollision->getHeight(x, z);
+}
+
+bool AiPlayer::isPredictionValid(const Vector& ballVelocity) const
+{
+    float time = m_predictTimer.read();
+    if (time > m_predictBounce)
+    {
+        return false;
+    }
+
+    Vector expected = m_predictVelocity + m_gravity * time;
+    return (expected - ballVelocity).magnitude2() < PREDICT_TOLERANCE * PREDICT_TOLERANCE;
+}
+
+void AiPlayer::predict(const Vector& ballPosition, const Vector& ballVelocity)
+{
+    m_predictTimer.reset();
+    m_predictVelocity = ballVelocity;
+    m_predictBounce = PREDICT_TIME;
+    m_predictFound = false;
+
+    Vector position = ballPosition;
+    Vector velocity = ballVelocity;
+    for (float time = 0.0f; time < PREDICT_TIME; time += PREDICT_STEP)
+    {
+        velocity += m_gravity * PREDICT_STEP;
+        position += velocity * PREDICT_STEP;
+
+        float ground = getGroundHeight(position.x, position.z) + BALL_RADIUS;
+        if (position.y < ground)
+        {
+            position.y = ground;
+            velocity.y = -velocity.y * BOUNCE_RESTITUTION;
+            velocity.x *= BOUNCE_FRICTION;
+            velocity.z *= BOUNCE_FRICTION;
+
+            m_predictBounce = std::min(m_predictBounce, time);
+        }
+
+        if (velocity.y <= 0.0f && position.y < PREDICT_REACH &&
+            isPointInRectangle(position, m_lowerLeft, m_upperRight))
+        {
+            m_predictFound = true;
+            m_predictTarget = position;
+            return;
+        }
+    }
+}
+
 void AiPlayer::control()
 {
-    Body* ball = World::instance->m_level->getBody("football");
+    Body* ball = m_ballBody;
 
     Vector ballPosition = ball->getPosition();
     const Vector selfPosition = m_body->getPosition();
@@ -38,7 +115,26 @@ void AiPlayer::control()
 
     bool important = true;
 
-    if (!isPointInRectangle(ballPosition, m_lowerLeft, m_upperRight))
+    if (m_predict)
+    {
+        Vector ballVelocity = ball->getVelocity();
+        if (!isPredictionValid(ballVelocity))
+        {
+            predict(ballPosition, ballVelocity);
+        }
+
+        if (m_predictFound)
+        {
+            ballPosition = m_predictTarget;
+        }
+        else if (!isPointInRectangle(ballPosition, m_lowerLeft, m_upperRight))
+        {
+            // ball is not coming to players field
+            ballPosition = getFieldCenter();
+            important = false;
+        }
+    }
+    else if (!isPointInRectangle(ballPosition, m_lowerLeft, m_upperRight))
     {
         Vector ballVelocity;
         NewtonBodyGetVelocity(ball->m_newtonBody, ballVelocity.v);
@@ -17,6 +17,21 @@ public:
 
     void control();
     void control(const ControlPacket& packet);
+
+private:
+    // predictive mode, ball trajectory is integrated until it reaches
+    // players field and is cached until ball velocity changes
+    bool   m_predict;
+    Vector m_gravity;
+    Timer  m_predictTimer;
+    Vector m_predictVelocity;
+    float  m_predictBounce;
+    bool   m_predictFound;
+    Vector m_predictTarget;
+
+    bool isPredictionValid(const Vector& ballVelocity) const;
+    void predict(const Vector& ballPosition, const Vector& ballVelocity);
+    float getGroundHeight(float x, float z) const;
 };
 
 #endif
@@ -7,16 +7,15 @@
 #include "packet.h"
 
 LocalPlayer::LocalPlayer(const Profile* profile, Level* level) :
-    Player(profile, level), m_cpacket(NULL) //Config::instance->m_misc.mouse_sensitivity)
+    Player(profile, level), //Config::instance->m_misc.mouse_sensitivity)
+    m_hasControl(false),
+    m_controlJump(false),
+    m_controlKick(false)
 {
 }
 
 LocalPlayer::~LocalPlayer()
 {
-    if (m_cpacket != NULL)
-    {
-        delete m_cpacket;
-    }
 }
 
 void LocalPlayer::control()
@@ -28,12 +27,7 @@ void LocalPlayer::control()
         setDirection(Vector::Zero);
         setRotation(Vector::Zero);
 
-        if (m_cpacket != NULL)
-        {
-            delete m_cpacket;
-        }
-        
-        m_cpacket = new ControlPacket(Network::instance->getLocalIdx(), Vector::Zero, Vector::Zero, false, false);
+        setControl(Vector::Zero, Vector::Zero, false, false);
         return;
     }
     Vector direction = curMouse;
@@ -51,9 +45,7 @@ void LocalPlayer::control()
 
     Vector finalDirection = Matrix::rotateY(World::instance->m_camera->angleY()) * direction;
 
-    Body* ball = World::instance->m_level->getBody("football");
-
-    Vector ballPosition = ball->getPosition();
+    Vector ballPosition = m_ballBody->getPosition();
     Vector selfPosition = m_body->getPosition();
 
     Vector dir = ballPosition - selfPosition;
@@ -74,21 +66,33 @@ void LocalPlayer::control()
     }
     else
     {
-        if (m_cpacket != NULL)
-        {
-            delete m_cpacket;
-        }
-        
-        m_cpacket = new ControlPacket(Network::instance->getLocalIdx(), finalDirection, rotation, jump, kick);
+        setControl(finalDirection, rotation, jump, kick);
     }
 }
 
+void LocalPlayer::setControl(const Vector& direction, const Vector& rotation, bool jump, bool kick)
+{
+    m_hasControl = true;
+    m_controlDirection = direction;
+    m_controlRotation = rotation;
+    m_controlJump = jump;
+    m_controlKick = kick;
+}
+
 void LocalPlayer::control(const ControlPacket& packet)
 {
     clog << "LocalPlayer::control - invalid call" << endl;
 }
 
-ControlPacket* LocalPlayer::getControl(int idx)
+bool LocalPlayer::getControl(Vector& direction, Vector& rotation, bool& jump, bool& kick) const
 {
-    return m_cpacket;
+    if (!m_hasControl)
+    {
+        return false;
+    }
+    direction = m_controlDirection;
+    rotation = m_controlRotation;
+    jump = m_controlJump;
+    kick = m_controlKick;
+    return true;
 }
\ No newline at end of file
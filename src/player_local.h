@@ -12,12 +12,20 @@ public:
 
     void control();
     void control(const ControlPacket& packet);
-    ControlPacket* getControl(int idx);
+    bool getControl(Vector& direction, Vector& rotation, bool& jump, bool& kick) const;
 
 private:
     Vector         m_lastMove[2];
     float          m_mouseSens;
-    ControlPacket* m_cpacket;
+
+    // packet is built only when network sends it, its data is in frame memory
+    bool           m_hasControl;
+    Vector         m_controlDirection;
+    Vector         m_controlRotation;
+    bool           m_controlJump;
+    bool           m_controlKick;
+
+    void setControl(const Vector& direction, const Vector& rotation, bool jump, bool kick);
 
 };
 
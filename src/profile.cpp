@@ -9,7 +9,8 @@ Profile::Profile() :
     m_color(Pink),
     m_speed(0.5f),
     m_accuracy(0.5f),
-    m_jump(0.5f)
+    m_jump(0.5f),
+    m_predict(false)
 {
 }
 
@@ -19,7 +20,8 @@ Profile::Profile(const Profile& profile) :
     m_color(profile.m_color),
     m_speed(profile.m_speed),
     m_accuracy(profile.m_accuracy),
-    m_jump(profile.m_jump)
+    m_jump(profile.m_jump),
+    m_predict(profile.m_predict)
 {
 }
 
@@ -29,7 +31,8 @@ Profile::Profile(const XMLnode& node) :
     m_color(Pink),
     m_speed(0.5f),
     m_accuracy(0.5f),
-    m_jump(0.5f)
+    m_jump(0.5f),
+    m_predict(false)
 {
     for each_const(XMLnodes, node.childs, iter)
     {
@@ -52,6 +55,10 @@ Profile::Profile(const XMLnode& node) :
             m_jump = node.getAttribute<float>("jump");
             m_accuracy = node.getAttribute<float>("accuracy");
         }
+        else if (node.name == "ai")
+        {
+            m_predict = (node.getAttribute("mode") == "predict");
+        }
         else
         {
             string line = cast<string>(node.line);
@@ -19,6 +19,7 @@ public:
     float  m_speed;
     float  m_accuracy;
     float  m_jump;
+    bool   m_predict; // ai predicts ball trajectory
 };
 
 #endif
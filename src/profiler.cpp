@@ -0,0 +1,445 @@
+#include <iomanip>
+#include <cstring>
+
+#include "video.h"
+#include "profiler.h"
+#include "timer.h"
+#include "font.h"
+#include "file.h"
+#include "memory_budget.h"
+#include "frame_allocator.h"
+
+static const string TRACE_FILE = "/trace.json";
+static const float OVERLAY_UPDATE = 1.0f; // seconds
+
+// GPU results are read this many frames later, so reading never waits
+static const int GPU_FRAMES = 3;
+static const GLenum TIMESTAMP = 0x8E28; // GL_TIMESTAMP
+
+typedef void (APIENTRY * QueryCounterProc)(GLuint id, GLenum target);
+typedef void (APIENTRY * GetQueryObjectui64vProc)(GLuint id, GLenum pname, unsigned long long* params);
+
+struct Zone
+{
+    const char*  name;
+    int          parent;
+    double       time;
+    unsigned int calls;
+
+    bool         gpu;
+    double       gpuTime;
+    double       captureGpuTime;
+    double       recordGpuTime;
+};
+
+struct GpuQuery
+{
+    int    zone;
+    GLuint begin;
+    GLuint end;
+};
+
+struct GpuFrame
+{
+    vector<GLuint>   pool;
+    size_t           used;
+    vector<GpuQuery> queries;
+};
+
+struct TraceEvent
+{
+    const char* name;
+    double      start;
+    double      duration;
+};
+
+static bool visible = false;
+static vector<Zone> zones;
+static IntVector open;
+static vector<double> starts;
+
+static unsigned int frames = 0;
+static double nextUpdate = 0.0;
+static string overlay;
+
+static unsigned long heapLast = 0;
+static size_t framePeak = 0;
+
+static int captureLeft = 0;
+static double captureStart = 0.0;
+static vector<TraceEvent> trace;
+
+static int gpuSupported = -1; // checked when first needed
+static QueryCounterProc queryCounter = NULL;
+static GetQueryObjectui64vProc getQueryObjectui64v = NULL;
+static GpuFrame gpuFrames[GPU_FRAMES];
+static int gpuFrame = 0;
+static IntVector gpuOpen;
+static unsigned int gpuReadFrames = 0;
+static unsigned int captureGpuFrames = 0;
+
+static bool recording = false;
+static unsigned int recordGpuFrames = 0;
+
+static bool haveGPU()
+{
+    if (gpuSupported == -1)
+    {
+        if (glfwExtensionSupported("GL_ARB_timer_query") == GL_TRUE)
+        {
+            queryCounter = reinterpret_cast<QueryCounterProc>(glfwGetProcAddress("glQueryCounter"));
+            getQueryObjectui64v = reinterpret_cast<GetQueryObjectui64vProc>(glfwGetProcAddress("glGetQueryObjectui64v"));
+        }
+        gpuSupported = (queryCounter != NULL && getQueryObjectui64v != NULL && GLEE_VERSION_1_5 == GL_TRUE) ? 1 : 0;
+        clog << "Video: GL_ARB_timer_query " << (gpuSupported ? "supported." : "unavailable.") << endl;
+    }
+    return gpuSupported == 1;
+}
+
+static GLuint allocateQuery(GpuFrame& frame)
+{
+    if (frame.used == frame.pool.size())
+    {
+        GLuint id;
+        glGenQueries(1, &id);
+        frame.pool.push_back(id);
+    }
+    return frame.pool[frame.used++];
+}
+
+// collects results of frame issued GPU_FRAMES ago and reuses its queries
+static void readGPU()
+{
+    gpuFrame = (gpuFrame + 1) % GPU_FRAMES;
+    GpuFrame& frame = gpuFrames[gpuFrame];
+    if (frame.queries.empty())
+    {
+        return;
+    }
+
+    GLint available = 0;
+    glGetQueryObjectiv(frame.queries.back().end, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available)
+    {
+        for each_const(vector<GpuQuery>, frame.queries, iter)
+        {
+            unsigned long long begin, end;
+            getQueryObjectui64v(iter->begin, GL_QUERY_RESULT, &begin);
+            getQueryObjectui64v(iter->end, GL_QUERY_RESULT, &end);
+
+            const double time = static_cast<double>(end - begin) / 1000000000.0;
+            zones[iter->zone].gpuTime += time;
+            if (captureLeft > 0)
+            {
+                zones[iter->zone].captureGpuTime += time;
+            }
+            if (recording)
+            {
+                zones[iter->zone].recordGpuTime += time;
+            }
+        }
+        gpuReadFrames++;
+        if (captureLeft > 0)
+        {
+            captureGpuFrames++;
+        }
+        if (recording)
+        {
+            recordGpuFrames++;
+        }
+    }
+
+    frame.queries.clear();
+    frame.used = 0;
+}
+
+static void logGPU()
+{
+    for each_const(vector<Zone>, zones, iter)
+    {
+        if (!iter->gpu)
+        {
+            continue;
+        }
+        clog << "GPU " << iter->name << ": ";
+        if (gpuSupported == 1 && captureGpuFrames != 0)
+        {
+            clog << iter->captureGpuTime * 1000.0 / captureGpuFrames << " ms" << endl;
+        }
+        else
+        {
+            clog << "n/a" << endl;
+        }
+    }
+}
+
+static int findZone(int parent, const char* name)
+{
+    for (size_t i = 0; i < zones.size(); i++)
+    {
+        if (zones[i].parent == parent && (zones[i].name == name || strcmp(zones[i].name, name) == 0))
+        {
+            return static_cast<int>(i);
+        }
+    }
+
+    Zone zone = { name, parent, 0.0, 0, false, 0.0, 0.0, 0.0 };
+    zones.push_back(zone);
+    return static_cast<int>(zones.size()) - 1;
+}
+
+static void describe(std::ostream& stream, int parent, int depth)
+{
+    for (size_t i = 0; i < zones.size(); i++)
+    {
+        const Zone& zone = zones[i];
+        if (zone.parent != parent)
+        {
+            continue;
+        }
+        stream << string(2 * depth, ' ') << zone.name << "  "
+               << std::fixed << std::setprecision(2) << zone.time * 1000.0 / frames << " ms";
+        if (zone.gpu)
+        {
+            stream << "  gpu ";
+            if (gpuSupported == 1 && gpuReadFrames != 0)
+            {
+                stream << zone.gpuTime * 1000.0 / gpuReadFrames << " ms";
+            }
+            else
+            {
+                stream << "n/a";
+            }
+        }
+        if (zone.calls != frames)
+        {
+            stream << std::setprecision(1) << "  x" << static_cast<float>(zone.calls) / frames;
+        }
+        stream << endl;
+        describe(stream, static_cast<int>(i), depth + 1);
+    }
+}
+
+static void writeTrace()
+{
+    std::ostringstream stream;
+    stream << std::fixed << std::setprecision(3);
+    stream << "{\"traceEvents\":[" << endl;
+    for (size_t i = 0; i < trace.size(); i++)
+    {
+        const TraceEvent& event = trace[i];
+        stream << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1"
+               << ",\"ts\":" << (event.start - captureStart) * 1000000.0
+               << ",\"dur\":" << event.duration * 1000000.0 << "}"
+               << (i + 1 < trace.size() ? "," : "") << endl;
+    }
+    stream << "],\"displayTimeUnit\":\"ms\"}" << endl;
+
+    const string data = stream.str();
+    File::Writer out(TRACE_FILE);
+    if (!out.is_open())
+    {
+        clog << "Failed to write profiler trace '" << TRACE_FILE << "'" << endl;
+        return;
+    }
+    out.write(data.c_str(), data.size());
+    out.close();
+
+    clog << "Profiler trace with " << trace.size() << " zones written to '" << TRACE_FILE << "'" << endl;
+    trace.clear();
+
+    logGPU();
+}
+
+void Profiler::setVisible(bool show)
+{
+    visible = show;
+    frames = 0;
+    nextUpdate = Timer::precise() + OVERLAY_UPDATE;
+    overlay.clear();
+    heapLast = MemoryBudget::heapAllocations();
+    framePeak = 0;
+    for (size_t i = 0; i < zones.size(); i++)
+    {
+        zones[i].time = 0.0;
+        zones[i].calls = 0;
+        zones[i].gpuTime = 0.0;
+    }
+    gpuReadFrames = 0;
+}
+
+bool Profiler::isVisible()
+{
+    return visible;
+}
+
+bool Profiler::isEnabled()
+{
+    return visible || captureLeft > 0 || recording;
+}
+
+void Profiler::record(bool enabled)
+{
+    recording = enabled;
+    if (!enabled)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < zones.size(); i++)
+    {
+        zones[i].recordGpuTime = 0.0;
+    }
+    recordGpuFrames = 0;
+}
+
+double Profiler::getRecordedGPU(const char* name)
+{
+    double time = 0.0;
+    bool found = false;
+    for each_const(vector<Zone>, zones, iter)
+    {
+        if (iter->gpu && strcmp(iter->name, name) == 0)
+        {
+            time += iter->recordGpuTime;
+            found = true;
+        }
+    }
+
+    if (!found || gpuSupported != 1 || recordGpuFrames == 0)
+    {
+        return -1.0;
+    }
+    return time / recordGpuFrames;
+}
+
+void Profiler::capture(int frames)
+{
+    if (captureLeft > 0)
+    {
+        return;
+    }
+    clog << "Profiler capturing " << frames << " frames." << endl;
+    captureLeft = frames;
+    captureStart = Timer::precise();
+    trace.clear();
+
+    for (size_t i = 0; i < zones.size(); i++)
+    {
+        zones[i].captureGpuTime = 0.0;
+    }
+    captureGpuFrames = 0;
+}
+
+void Profiler::frame()
+{
+    assert(open.empty());
+
+    if (gpuSupported == 1)
+    {
+        readGPU();
+    }
+
+    if (captureLeft > 0 && --captureLeft == 0)
+    {
+        writeTrace();
+    }
+
+    if (!visible)
+    {
+        return;
+    }
+
+    frames++;
+    framePeak = std::max(framePeak, FrameAllocator::lastFrameUsed());
+    double now = Timer::precise();
+    if (now >= nextUpdate)
+    {
+        const unsigned long heap = MemoryBudget::heapAllocations();
+
+        std::ostringstream stream;
+        describe(stream, -1, 0);
+        MemoryBudget::describe(stream);
+        stream << std::setprecision(1) << "heap allocations  " << static_cast<float>(heap - heapLast) / frames
+               << " per frame, frame memory peak " << framePeak / 1024 << " KB" << endl;
+        overlay = stream.str();
+        heapLast = heap;
+        framePeak = 0;
+
+        for (size_t i = 0; i < zones.size(); i++)
+        {
+            zones[i].time = 0.0;
+            zones[i].calls = 0;
+            zones[i].gpuTime = 0.0;
+        }
+        frames = 0;
+        gpuReadFrames = 0;
+        nextUpdate = now + OVERLAY_UPDATE;
+    }
+}
+
+void Profiler::begin(const char* name)
+{
+    open.push_back(findZone(open.empty() ? -1 : open.back(), name));
+    starts.push_back(Timer::precise());
+}
+
+void Profiler::end()
+{
+    double now = Timer::precise();
+    double start = starts.back();
+
+    Zone& zone = zones[open.back()];
+    zone.time += now - start;
+    zone.calls++;
+
+    if (captureLeft > 0)
+    {
+        TraceEvent event = { zone.name, start, now - start };
+        trace.push_back(event);
+    }
+
+    open.pop_back();
+    starts.pop_back();
+}
+
+void Profiler::beginGPU()
+{
+    zones[open.back()].gpu = true;
+    if (!haveGPU())
+    {
+        return;
+    }
+
+    GpuFrame& frame = gpuFrames[gpuFrame];
+    GpuQuery query = { open.back(), allocateQuery(frame), allocateQuery(frame) };
+    queryCounter(query.begin, TIMESTAMP);
+    frame.queries.push_back(query);
+    gpuOpen.push_back(static_cast<int>(frame.queries.size()) - 1);
+}
+
+void Profiler::endGPU()
+{
+    if (gpuSupported != 1)
+    {
+        return;
+    }
+
+    queryCounter(gpuFrames[gpuFrame].queries[gpuOpen.back()].end, TIMESTAMP);
+    gpuOpen.pop_back();
+}
+
+void Profiler::render(float top)
+{
+    if (!visible || overlay.empty())
+    {
+        return;
+    }
+
+    const Font* font = Font::get("Arial_12pt_bold");
+    font->begin();
+    glTranslatef(3.0f, top - static_cast<float>(font->getHeight()), 0.0f);
+    glColor3f(0.8f, 1.0f, 0.8f);
+    font->render(overlay);
+    font->end();
+}
@@ -0,0 +1,72 @@
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#include "common.h"
+
+// hierarchical timing of named zones in main thread, zone times are
+// averaged over one second for overlay, captured frames are written
+// to write directory in Chrome trace format (chrome://tracing);
+// zones can be also timed on GPU if GL_ARB_timer_query is available
+class Profiler
+{
+public:
+    static void setVisible(bool visible);
+    static bool isVisible();
+    static bool isEnabled(); // overlay is visible, capture or recording is running
+
+    // starts recording next frames, trace is written when they are done
+    static void capture(int frames);
+
+    // once per frame, outside of any zone
+    static void frame();
+
+    // name must stay valid, usually string literal
+    static void begin(const char* name);
+    static void end();
+
+    // times innermost zone on GPU, results are read few frames later
+    static void beginGPU();
+    static void endGPU();
+
+    static void render(float top);
+
+    // benchmark keeps zones enabled without overlay and sums GPU times
+    static void record(bool enabled);
+    // average GPU time in seconds of named zones over recorded frames,
+    // negative if zone was not timed on GPU
+    static double getRecordedGPU(const char* name);
+};
+
+class ProfileZone : public NoCopy
+{
+public:
+    ProfileZone(const char* name, bool gpu = false) : m_active(Profiler::isEnabled()), m_gpu(gpu && m_active)
+    {
+        if (m_active)
+        {
+            Profiler::begin(name);
+        }
+        if (m_gpu)
+        {
+            Profiler::beginGPU();
+        }
+    }
+
+    ~ProfileZone()
+    {
+        if (m_gpu)
+        {
+            Profiler::endGPU();
+        }
+        if (m_active)
+        {
+            Profiler::end();
+        }
+    }
+
+private:
+    bool m_active;
+    bool m_gpu;
+};
+
+#endif
@@ -14,6 +14,14 @@
 #include "audio.h"
 #include "network.h"
 
+// important sounds always win over other sounds, otherwise nearest wins
+static const float IMPORTANT_PRIORITY = 1000.0f;
+
+static float getPriority(bool important, const Vector& position, const Vector& listener)
+{
+    return (important ? IMPORTANT_PRIORITY : 0.0f) - (position - listener).magnitude();
+}
+
 struct MaterialContact : NoCopy
 {
     static int onBegin(const NewtonMaterial* material, const NewtonBody* body0, const NewtonBody* body1);
@@ -31,7 +39,7 @@ struct MaterialContact : NoCopy
     float  maxSpeed;
 };
 
-Properties::Properties() : m_uniqueID(2), m_soundBufID(0)
+Properties::Properties() : m_uniqueID(2), m_soundBufID(0), m_tableSize(0), m_freeCount(0)
 {
     NewtonWorld* world = World::instance->m_newtonWorld;
     int defaultID = NewtonMaterialGetDefaultGroupID(world);
@@ -47,23 +55,24 @@ Properties::Properties() : m_uniqueID(2), m_soundBufID(0)
         MaterialContact::onProcess,
         MaterialContact::onEnd);
 
-    for (int i=0; i<8; i++)
+    for (int i=0; i<VOICE_COUNT; i++)
     {
-        m_idle.push_back(Soundable(new Sound(false), i<4+1)); // 5 important sources!
+        m_voices[i].sound = new Sound(false);
+        m_freeVoices[m_freeCount++] = i;
     }
+
+    // used in contact callbacks, so resolve them only once
+    m_footballID = getPropertyID("football");
+    m_playerID = getPropertyID("player");
 }
 
 Properties::~Properties()
 {
     delete m_materialContact;
 
-    for each_const(SoundableList, m_idle, iter)
-    {
-        delete iter->sound;
-    }
-    for each_const(SoundableList, m_active, iter)
+    for (int i=0; i<VOICE_COUNT; i++)
     {
-        delete iter->sound;
+        delete m_voices[i].sound;
     }
     for each_(SoundBufMap, m_soundBufs, iter)
     {
@@ -76,107 +85,111 @@ Properties::~Properties()
 
 void Properties::update()
 {
-    SoundableList::iterator iter = m_active.begin();
-    while (iter != m_active.end())
+    for (int i=0; i<VOICE_COUNT; i++)
     {
-        if (iter->sound->is_playing() == false)
+        if (m_voices[i].active && m_voices[i].sound->is_playing() == false)
         {
-            m_idle.push_back(*iter);
-            iter = m_active.erase(iter);
-        }
-        else
-        {
-            iter++;
+            releaseVoice(i);
         }
     }
 }
 
-void Properties::play(Body* body, const pair<byte, SoundBuffer*>* buffer, bool important, const Vector& position)
+void Properties::releaseVoice(int idx)
 {
-    if (buffer == NULL)
+    Voice& voice = m_voices[idx];
+    if (voice.body != NULL)
     {
-        return;
+        voice.body->m_voice = -1;
     }
+    voice.body = NULL;
+    voice.active = false;
+    m_freeVoices[m_freeCount++] = idx;
+}
 
-    // check if not already playing
-    SoundableList::iterator iterA = m_active.begin();
-    while (iterA != m_active.end())
+int Properties::getVoice(bool important, const Vector& position)
+{
+    if (m_freeCount == 0)
     {
-        if (iterA->body == body)
+        Vector listener;
+        alGetListenerfv(AL_POSITION, listener.v);
+
+        int victim = -1;
+        float victimPriority = getPriority(important, position, listener);
+        for (int i=0; i<VOICE_COUNT; i++)
+        {
+            float priority = getPriority(m_voices[i].important, m_voices[i].position, listener);
+            if (priority < victimPriority)
+            {
+                victim = i;
+                victimPriority = priority;
+            }
+        }
+
+        if (victim == -1)
         {
-            return;
+            return -1;
         }
-        iterA++;
+        m_voices[victim].sound->stop();
+        releaseVoice(victim);
+    }
+
+    return m_freeVoices[--m_freeCount];
+}
+
+void Properties::startVoice(int idx, Body* body, bool important, const SoundBuffer* buffer, 
+                            const Vector& position, const Vector& velocity)
+{
+    Voice& voice = m_voices[idx];
+    voice.body = body;
+    voice.important = important;
+    voice.active = true;
+    voice.position = position;
+    if (body != NULL)
+    {
+        body->m_voice = idx;
     }
 
-    // check for free space
-    SoundableList::iterator iterI = m_idle.begin();
-    while (iterI != m_idle.end() && iterI->important != important)
+    voice.sound->play(buffer);
+    voice.sound->update(position, velocity);
+}
+
+void Properties::play(Body* body, const pair<byte, SoundBuffer*>* buffer, bool important, const Vector& position)
+{
+    if (buffer == NULL || body->m_voice != -1)
     {
-        iterI++;
+        return;
     }
-    if (iterI == m_idle.end())
+
+    int idx = getVoice(important, position);
+    if (idx == -1)
     {
         return;
     }
 
     Network::instance->addSoundPacket(buffer->first, position);
 
-    iterI->sound->play(buffer->second);
-    iterI->sound->update(position, body->getVelocity());
-
-    m_active.push_back(*iterI);
-    m_idle.erase(iterI);
+    startVoice(idx, body, important, buffer->second, position, body->getVelocity());
 }
 
 void Properties::play(byte id, const Vector& position)
 {
-    SoundBuffer* buffer = NULL;
-    for each_const(SoundBufMap, m_soundBufs, iter)
-    {
-        for each_const(SoundBufferVector, iter->second, iter2)
-        {
-            if (iter2->first == id)
-            {
-                buffer = iter2->second;
-                break;
-            }
-        }
-        if (buffer != NULL)
-        {
-            break;
-        }
-    }
-
-    if (buffer == NULL)
+    if (id >= m_soundBufByID.size())
     {
         return;
     }
 
-    // check for free space
-    if (m_idle.size() == 0)
+    int idx = getVoice(false, position);
+    if (idx == -1)
     {
         return;
     }
-    SoundableList::iterator iterI = m_idle.begin();
-
-    iterI->sound->play(buffer);
-    iterI->sound->update(position, Vector::Zero);
 
-    m_active.push_back(*iterI);
-    m_idle.erase(iterI);
+    startVoice(idx, NULL, false, m_soundBufByID[id], position, Vector::Zero);
 }
 
-bool Properties::isPlaying(Body* body) const
+bool Properties::isPlaying(const Body* body) const
 {
-    for each_const(SoundableList, m_active, iter)
-    {
-        if (iter->body == body)
-        {
-            return true;
-        }
-    }
-    return false;
+    return body->m_voice != -1;
 }
 
 int  Properties::getUndefined() const
@@ -193,6 +206,16 @@ int  Properties::getDefault() const
 {
     return 2;
 }
+
+int  Properties::getFootball() const
+{
+    return m_footballID;
+}
+
+int  Properties::getPlayer() const
+{
+    return m_playerID;
+}
     
 int Properties::getPropertyID(const string& name)
 {
@@ -236,7 +259,7 @@ bool Properties::hasPropertyID(int id) const
     return id >= 2;
 }
 
-void Properties::load(const XMLnode& node)
+void Properties::load(const XMLelement& node)
 {
     string prop0 = node.getAttribute("property0");
     string prop1 = node.getAttribute("property1");
@@ -260,20 +283,23 @@ void Properties::load(const XMLnode& node)
     m_properties.insert(make_pair(makepID(id0, id1), Property(sF, kF, eC, sC)));
 
     SoundBufferVector& vec = m_soundBufs.insert(make_pair(makepID(id0, id1), SoundBufferVector())).first->second;
-    for each_const(XMLnodes, node.childs, n)
+    for each_const(XMLelements, node.childs, n)
     {
         if (n->name == "sound")
         {
             vec.push_back(make_pair(m_soundBufID++, Audio::instance->loadSound(n->getAttribute("name"))));
+            m_soundBufByID.push_back(vec.back().second);
         }
         else
         {
             throw Exception("Invalid property node, expected sound child, but got - " + node.name);
         }       
     }
+
+    buildTables();
 }
 
-void Properties::loadDefault(const XMLnode& node)
+void Properties::loadDefault(const XMLelement& node)
 {
     NewtonWorld* world = World::instance->m_newtonWorld;
 
@@ -289,6 +315,36 @@ void Properties::loadDefault(const XMLnode& node)
     NewtonMaterialSetDefaultElasticity(world, defaultID, defaultID, eC);
     NewtonMaterialSetDefaultFriction(world, defaultID, defaultID, sF, kF);
     NewtonMaterialSetDefaultSoftness(world, defaultID, defaultID, sC);
+
+    buildTables();
+}
+
+void Properties::buildTables()
+{
+    // ids in loaded pairs are never larger than current unique id
+    m_tableSize = m_uniqueID + 1;
+    m_propertyTable.assign(m_tableSize * m_tableSize, NULL);
+    m_soundBufTable.assign(m_tableSize * m_tableSize, NULL);
+
+    for each_const(PropertiesMap, m_properties, iter)
+    {
+        int id0 = static_cast<int>(iter->first >> 32);
+        int id1 = static_cast<int>(iter->first & 0xFFFFFFFF);
+        m_propertyTable[id0 * m_tableSize + id1] = &iter->second;
+        m_propertyTable[id1 * m_tableSize + id0] = &iter->second;
+    }
+
+    for each_const(SoundBufMap, m_soundBufs, iter)
+    {
+        if (iter->second.empty())
+        {
+            continue;
+        }
+        int id0 = static_cast<int>(iter->first >> 32);
+        int id1 = static_cast<int>(iter->first & 0xFFFFFFFF);
+        m_soundBufTable[id0 * m_tableSize + id1] = &iter->second;
+        m_soundBufTable[id1 * m_tableSize + id0] = &iter->second;
+    }
 }
 
 pID Properties::makepID(int id0, int id1) const
@@ -303,33 +359,93 @@ pID Properties::makepID(int id0, int id1) const
 
 const Property* Properties::get(int id0, int id1) const
 {
-    PropertiesMap::const_iterator iter = m_properties.find(makepID(id0, id1));
+    if (static_cast<unsigned int>(id0) >= static_cast<unsigned int>(m_tableSize) ||
+        static_cast<unsigned int>(id1) >= static_cast<unsigned int>(m_tableSize))
+    {
+        return NULL;
+    }
+    return m_propertyTable[id0 * m_tableSize + id1];
+}
     
-    if (iter != m_properties.end())
+const pair<byte, SoundBuffer*>* Properties::getSB(int id0, int id1) const
+{
+    if (static_cast<unsigned int>(id0) >= static_cast<unsigned int>(m_tableSize) ||
+        static_cast<unsigned int>(id1) >= static_cast<unsigned int>(m_tableSize))
     {
-        return &iter->second;
+        return NULL;
     }
-    else
+
+    const SoundBufferVector* vec = m_soundBufTable[id0 * m_tableSize + id1];
+    if (vec == NULL)
     {
         return NULL;
     }
+
+    int r = Randoms::getIntN(static_cast<int>(vec->size()));
+    return &(*vec)[r];
 }
-    
-const pair<byte, SoundBuffer*>* Properties::getSB(int id0, int id1) const
+
+void Properties::benchmark(unsigned int lookups) const
 {
-    SoundBufMap::const_iterator iter = m_soundBufs.find(makepID(id0, id1));
-    
-    if (iter != m_soundBufs.end())
+    if (m_tableSize <= getDefault())
     {
-        const SoundBufferVector& vec = iter->second;
-        if (vec.size() > 0)
+        return;
+    }
+
+    unsigned int found = 0;
+    double time = glfwGetTime();
+    for (unsigned int i = 0; i < lookups; i++)
+    {
+        int id0 = i % m_tableSize;
+        int id1 = (i / m_tableSize) % m_tableSize;
+        if (m_properties.find(makepID(id0, id1)) != m_properties.end())
+        {
+            found++;
+        }
+    }
+    double mapTime = glfwGetTime() - time;
+
+    time = glfwGetTime();
+    for (unsigned int i = 0; i < lookups; i++)
+    {
+        int id0 = i % m_tableSize;
+        int id1 = (i / m_tableSize) % m_tableSize;
+        if (get(id0, id1) != NULL)
+        {
+            found++;
+        }
+    }
+    double tableTime = glfwGetTime() - time;
+
+    // what MaterialContact does for one contact: pair property with
+    // fallback to default and sound buffers of pair (without random pick)
+    unsigned int sounds = 0;
+    time = glfwGetTime();
+    for (unsigned int i = 0; i < lookups; i++)
+    {
+        int id0 = i % m_tableSize;
+        int id1 = (i / m_tableSize) % m_tableSize;
+        if (!hasPropertyID(id0))
+        {
+            id0 = getDefault();
+        }
+        const Property* prop = get(id0, id1);
+        if (prop == NULL)
+        {
+            prop = get(getDefault(), getDefault());
+        }
+        if (prop != NULL && m_soundBufTable[id0 * m_tableSize + id1] != NULL)
         {
-            int r = Randoms::getIntN(static_cast<int>(vec.size()));
-            return &vec[r];
+            sounds++;
         }
     }
+    double contactTime = glfwGetTime() - time;
 
-    return NULL;
+    clog << "Property lookups (" << m_tableSize << " ids, " << found / 2 << " found, " 
+         << sounds << " with sound): " << endl
+         << "  map     - " << (mapTime > 0.0 ? lookups / mapTime : 0.0) << " per second" << endl
+         << "  table   - " << (tableTime > 0.0 ? lookups / tableTime : 0.0) << " per second" << endl
+         << "  contact - " << (contactTime > 0.0 ? lookups / contactTime : 0.0) << " per second" << endl;
 }
 
 int MaterialContact::onBegin(const NewtonMaterial* material, const NewtonBody* body0, const NewtonBody* body1)
@@ -362,7 +478,7 @@ int MaterialContact::onProcess(const NewtonMaterial* material, const NewtonConta
     {
         self->body[0]->onCollideHull(self->body[1]);
 
-        const Property * prop = self->properties->get((faceAttr ? faceAttr : colID1), self->properties->getPropertyID("football"));
+        const Property * prop = self->properties->get((faceAttr ? faceAttr : colID1), self->properties->getFootball());
         if (prop != NULL)
         {
             prop->apply(material);
@@ -372,7 +488,7 @@ int MaterialContact::onProcess(const NewtonMaterial* material, const NewtonConta
     else if (colID1 == self->properties->getInvisible())
     {
         self->body[1]->onCollideHull(self->body[0]);
-        const Property * prop = self->properties->get((faceAttr ? faceAttr : colID0), self->properties->getPropertyID("football"));
+        const Property * prop = self->properties->get((faceAttr ? faceAttr : colID0), self->properties->getFootball());
         if (prop != NULL)
         {
             prop->apply(material);
@@ -441,7 +557,7 @@ int MaterialContact::onProcess(const NewtonMaterial* material, const NewtonConta
         prop = self->properties->get(self->properties->getDefault(), 
                                      self->properties->getDefault());
     }
-    int playerID = self->properties->getPropertyID("player");
+    int playerID = self->properties->getPlayer();
     if (m0==playerID && m1==playerID)
     {
         // TODO: this is hack, to bounce players off each other
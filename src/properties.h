@@ -6,7 +6,7 @@
 #include "vmath.h"
 
 class Property;
-class XMLnode;
+class XMLelement;
 class Sound;
 class SoundBuffer;
 class Body;
@@ -15,18 +15,23 @@ struct MaterialContact;
 typedef long long pID;
 typedef map<pID, Property> PropertiesMap;
 
-struct Soundable
+static const int VOICE_COUNT = 8;
+
+struct Voice
 {
-    Soundable(Sound* sound, bool important) : body(NULL), sound(sound), important(important) {}
+    Voice() : sound(NULL), body(NULL), important(false), active(false) {}
 
-    Body*  body;
     Sound* sound;
+    Body*  body;
     bool   important;
+    bool   active;
+    Vector position;
 };
 
-typedef list<Soundable>                   SoundableList;
 typedef vector<pair<byte, SoundBuffer*> > SoundBufferVector;
 typedef map<pID, SoundBufferVector>       SoundBufMap;
+typedef vector<const Property*>           PropertyTable;
+typedef vector<const SoundBufferVector*>  SoundBufTable;
 
 class Properties : public NoCopy
 {
@@ -37,23 +42,29 @@ public:
 
     void update();
 
-    void load(const XMLnode& node);
-    void loadDefault(const XMLnode& node);
+    void load(const XMLelement& node);
+    void loadDefault(const XMLelement& node);
     const Property* get(int id0, int id1) const;
     const pair<byte, SoundBuffer*>* getSB(int id0, int id1) const;
 
     int  getUndefined() const;              // 0
     int  getInvisible() const;              // 1
     int  getDefault() const;                // 2
+    int  getFootball() const;               // interned "football"
+    int  getPlayer() const;                 // interned "player"
     int  getPropertyID(const string& name); // >=3
     int  getPropertyID(const string& name) const; // >=3
     bool hasPropertyID(int id) const; // id>=3
 
     void play(Body* body, const pair<byte, SoundBuffer*>* buffer, bool important, const Vector& position);
-    bool isPlaying(Body* body) const;
+    bool isPlaying(const Body* body) const;
 
     void play(byte id, const Vector& position);
 
+    // logs lookup speed of dense tables against maps and of lookups
+    // done by contact callback
+    void benchmark(unsigned int lookups) const;
+
 private:
     int                 m_uniqueID;
     PropertiesMap       m_properties;
@@ -61,11 +72,30 @@ private:
     byte                m_soundBufID;
     IntMap              m_propertiesID;
     MaterialContact*    m_materialContact;
+    int                 m_footballID;
+    int                 m_playerID;
 
     pID makepID(int id0, int id1) const;
 
-    SoundableList m_active;
-    SoundableList m_idle;
+    // dense id0*size+id1 tables built from maps after each load,
+    // so contact callbacks do only array indexing
+    int                 m_tableSize;
+    PropertyTable       m_propertyTable;
+    SoundBufTable       m_soundBufTable;
+
+    void buildTables();
+
+    // fixed voice pool, when all voices are busy voice with lowest
+    // priority (not important and farthest from listener) is stolen
+    Voice               m_voices[VOICE_COUNT];
+    int                 m_freeVoices[VOICE_COUNT];
+    int                 m_freeCount;
+    vector<SoundBuffer*> m_soundBufByID;
+
+    int  getVoice(bool important, const Vector& position);
+    void startVoice(int idx, Body* body, bool important, const SoundBuffer* buffer, 
+                    const Vector& position, const Vector& velocity);
+    void releaseVoice(int idx);
 };
 
 #endif
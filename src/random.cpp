@@ -141,6 +141,14 @@ void Randoms::init()
     }
 }
 
+void Randoms::init(unsigned int fixedSeed)
+{
+    clog << "Initializing random seed " << fixedSeed << "." << endl;
+
+    left = 0;
+    seed(fixedSeed);
+}
+
 unsigned int Randoms::getInt()
 {
     if (left == 0) reload();
@@ -6,6 +6,7 @@
 namespace Randoms
 {
     void init();
+    void init(unsigned int fixedSeed); // repeatable sequence
 
     unsigned int getInt();               // [0,2^32)
     unsigned int getIntN(unsigned int n); // [0,n)
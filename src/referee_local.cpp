@@ -267,7 +267,7 @@ void RefereeLocal::processCriticalEvent()
     if (maxScore.second >= m_matchPoints)
     {
         string overText;
-        if (maxScore.first == m_humanPlayer->m_profile->m_name)
+        if (m_humanPlayer != NULL && maxScore.first == m_humanPlayer->m_profile->m_name)
         {
             overText = Language::instance->get(TEXT_RESTART);
         }
@@ -0,0 +1,74 @@
+#if defined(_MSC_VER)
+#include <intrin.h>
+#pragma intrinsic(_ReadWriteBarrier)
+#endif
+
+#include <cstring>
+
+#include "ring_buffer.h"
+
+// data must be visible before index is published, on x86 only
+// compiler reordering needs to be prevented
+static inline void memoryBarrier()
+{
+#if defined(_MSC_VER)
+    _ReadWriteBarrier();
+#else
+    __sync_synchronize();
+#endif
+}
+
+RingBuffer::RingBuffer(size_t capacity) :
+    m_data(new char [capacity + 1]),
+    m_size(capacity + 1),
+    m_read(0),
+    m_write(0)
+{
+}
+
+RingBuffer::~RingBuffer()
+{
+    delete [] m_data;
+}
+
+size_t RingBuffer::readable() const
+{
+    size_t read = m_read;
+    size_t write = m_write;
+    return (write >= read ? write - read : m_size - read + write);
+}
+
+size_t RingBuffer::writable() const
+{
+    return m_size - 1 - readable();
+}
+
+size_t RingBuffer::read(char* data, size_t size)
+{
+    size = std::min(size, readable());
+    memoryBarrier();
+
+    size_t read = m_read;
+    size_t first = std::min(size, m_size - read);
+    std::memcpy(data, m_data + read, first);
+    std::memcpy(data + first, m_data, size - first);
+
+    memoryBarrier();
+    m_read = (read + size) % m_size;
+    return size;
+}
+
+size_t RingBuffer::write(const char* data, size_t size)
+{
+    size = std::min(size, writable());
+    memoryBarrier();
+
+    size_t write = m_write;
+    size_t first = std::min(size, m_size - write);
+    std::memcpy(m_data + write, data, first);
+    std::memcpy(m_data, data + first, size - first);
+
+    memoryBarrier();
+    m_write = (write + size) % m_size;
+    return size;
+}
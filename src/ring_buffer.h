@@ -0,0 +1,27 @@
+#ifndef __RING_BUFFER_H__
+#define __RING_BUFFER_H__
+
+#include "common.h"
+
+// byte queue without locks for exactly one producer thread
+// and exactly one consumer thread
+class RingBuffer : public NoCopy
+{
+public:
+    RingBuffer(size_t capacity);
+    ~RingBuffer();
+
+    size_t readable() const; // consumer
+    size_t writable() const; // producer
+
+    size_t read(char* data, size_t size);        // consumer
+    size_t write(const char* data, size_t size); // producer
+
+private:
+    char*           m_data;
+    size_t          m_size; // one byte is always left free
+    volatile size_t m_read;
+    volatile size_t m_write;
+};
+
+#endif
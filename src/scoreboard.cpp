@@ -149,7 +149,7 @@ void ScoreBoard::update()
     m_comboMessage->m_points = m_joinedCombo;
     for (size_t i = 0; i < m_playerOrder.size(); i++)
     {
-        m_scoreMessages[i]->m_score = m_scores[m_playerOrder[i]].m_total;
+        m_scoreMessages[i]->setScore(m_scores[m_playerOrder[i]].m_total);
         m_selfComboMessages[i]->m_points = m_scores[m_playerOrder[i]].m_combo;
     }
 }
@@ -9,27 +9,21 @@ Shader::Shader(const string& name) : m_program(0)
     string vp_filename = "/data/shaders/" + name + ".vsh.glsl";
     string fp_filename = "/data/shaders/" + name + ".fsh.glsl";
 
-    File::Reader file(vp_filename);
-    if (!file.is_open())
+    File::Contents vp(vp_filename);
+    if (!vp.is_open())
     {
         clog << Exception("Shader '" + vp_filename + "' not found") << endl;
         return ;
     }
-    vector<char> v(file.size());
-    file.read(&v[0], file.size());
-    file.close();
-    shaders[0].assign(v.begin(), v.end());
+    shaders[0].assign(vp.data(), vp.size());
 
-    file.open(fp_filename);
-    if (!file.is_open())
+    File::Contents fp(fp_filename);
+    if (!fp.is_open())
     {
         clog << Exception("Shader '" + fp_filename + "' not found") << endl;
         return ;
     }
-    v.resize(file.size());
-    file.read(&v[0], file.size());
-    file.close();
-    shaders[1].assign(v.begin(), v.end());
+    shaders[1].assign(fp.data(), fp.size());
         
     GLhandleARB objs[2] = {
         glCreateShaderObjectARB(GL_VERTEX_SHADER_ARB),
@@ -0,0 +1,137 @@
+#include "openal_includes.h"
+
+#include "simulation.h"
+#include "game.h"
+#include "world.h"
+#include "network.h"
+#include "referee_base.h"
+#include "scoreboard.h"
+#include "player.h"
+#include "profile.h"
+#include "timer.h"
+#include "random.h"
+#include "level.h"
+#include "properties.h"
+#include "frame_allocator.h"
+
+// matches that take longer are counted as unfinished
+static const unsigned int MAX_MATCH_TICKS = static_cast<unsigned int>(30 * 60 / DT);
+
+int          g_simulateMatches = 0;
+unsigned int g_simulateSeed = 0;
+unsigned int g_propertyLookups = 0;
+
+Simulation::Simulation(int matches) :
+    m_matches(matches),
+    m_unfinished(0)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        const vector<Profile*>& cpu = Game::instance->m_cpuProfiles[i];
+        m_profiles.insert(m_profiles.end(), cpu.begin(), cpu.end());
+    }
+
+    Timer::setSimulated(true);
+    alListenerf(AL_GAIN, 0.0f);
+}
+
+Simulation::~Simulation()
+{
+    Timer::setSimulated(false);
+}
+
+void Simulation::pickProfiles(vector<Profile*>& profiles) const
+{
+    profiles.clear();
+    while (profiles.size() < 4)
+    {
+        Profile* profile = m_profiles[Randoms::getIntN(static_cast<unsigned int>(m_profiles.size()))];
+        if (!foundIn(profiles, profile))
+        {
+            profiles.push_back(profile);
+        }
+    }
+}
+
+void Simulation::run()
+{
+    clog << "Simulating " << m_matches << " matches..." << endl;
+
+    int unlockable = 0;
+    World* world = new World(NULL, unlockable, 0, true);
+
+    unsigned int ticks = 0;
+    double seconds = 0.0;
+
+    vector<Profile*> profiles;
+    for (int match = 0; match < m_matches; match++)
+    {
+        pickProfiles(profiles);
+        Network::instance->setAiProfiles(profiles);
+
+        // float clock would lose precision over many matches
+        Timer::setSimulated(true);
+        world->init();
+
+        if (match == 0 && g_propertyLookups != 0)
+        {
+            world->m_level->m_properties->benchmark(g_propertyLookups);
+        }
+
+        // only ticks are timed, level loading is not
+        const double started = Timer::precise();
+        unsigned int tick = 0;
+        while (!world->m_referee->m_gameOver && tick < MAX_MATCH_TICKS)
+        {
+            world->control();
+            world->update(DT);
+            world->updateStep(DT);
+            Timer::advance(DT);
+            FrameAllocator::reset();
+            tick++;
+        }
+        seconds += Timer::precise() - started;
+        ticks += tick;
+
+        if (!world->m_referee->m_gameOver)
+        {
+            m_unfinished++;
+            continue;
+        }
+
+        string loser = world->m_referee->getLoserName();
+        for each_const(vector<Profile*>, profiles, iter)
+        {
+            const string& name = (*iter)->m_name;
+            SimulationStats& stats = m_stats[name];
+            stats.m_matches++;
+            stats.m_points += world->m_scoreBoard->getTotalPoints(name);
+            if (name == loser)
+            {
+                stats.m_losses++;
+            }
+        }
+    }
+
+    delete world;
+
+    report(ticks, seconds);
+}
+
+void Simulation::report(unsigned int ticks, double seconds) const
+{
+    // tab separated, so tools/simulate.py can merge output of many processes
+    for each_const(SimulationStatsMap, m_stats, iter)
+    {
+        const SimulationStats& stats = iter->second;
+        std::cout << "profile\t" << iter->first 
+                  << '\t' << stats.m_matches 
+                  << '\t' << stats.m_losses 
+                  << '\t' << stats.m_points << endl;
+    }
+    std::cout << "unfinished\t" << m_unfinished << endl;
+    std::cout << "ticks\t" << ticks << '\t' << seconds << endl;
+
+    clog << "Simulated " << ticks << " ticks in " << seconds << " seconds = " 
+         << (seconds > 0.0 ? ticks / seconds : 0.0) << " ticks per second" << endl;
+}
@@ -0,0 +1,43 @@
+#ifndef __SIMULATION_H__
+#define __SIMULATION_H__
+
+#include "common.h"
+
+class Profile;
+
+// set from command line: --simulate <matches> [seed]
+extern int          g_simulateMatches;
+extern unsigned int g_simulateSeed;
+// set from command line: --benchmark-properties [lookups], used with --simulate
+extern unsigned int g_propertyLookups;
+
+struct SimulationStats
+{
+    SimulationStats() : m_matches(0), m_losses(0), m_points(0) {}
+    int m_matches;
+    int m_losses;
+    int m_points;
+};
+
+typedef map<string, SimulationStats> SimulationStatsMap;
+
+// plays AI only matches without rendering or audio as fast as possible
+class Simulation : public NoCopy
+{
+public:
+    Simulation(int matches);
+    ~Simulation();
+
+    void run();
+
+private:
+    int                 m_matches;
+    int                 m_unfinished;
+    vector<Profile*>    m_profiles;
+    SimulationStatsMap  m_stats;
+
+    void pickProfiles(vector<Profile*>& profiles) const;
+    void report(unsigned int ticks, double seconds) const;
+};
+
+#endif
@@ -1,5 +1,7 @@
 #include "skybox.h"
 #include "texture.h"
+#include "mesh.h"
+#include "profiler.h"
 
 static const string facesTex[] = { "_FR", "_BK", "_UP"/*, "_DN"*/, "_RT", "_LF" };
 
@@ -42,19 +44,31 @@ SkyBox::SkyBox(const string& name)
 
     for (int i = 0; i < 5; i++)
     {
-        m_faces[i].uv.resize(4);
-        m_faces[i].vertexes.resize(4);
+        Face face;
+        face.uv.resize(4);
+        face.vertexes.resize(4);
         for (int k = 0; k < 4; k++)
         {
             const float* v = vertices[faces[i][k]];
-            m_faces[i].uv[k] = UV(uv[k][0], uv[k][1]);
-            m_faces[i].vertexes[k] = Vector(v[0], v[1], v[2]);
+            face.uv[k] = UV(uv[k][0], uv[k][1]);
+            face.vertexes[k] = Vector(v[0], v[1], v[2]);
         }
+        m_faces[i] = new FaceMesh(face);
+    }
+}
+
+SkyBox::~SkyBox()
+{
+    for (int i = 0; i < 5; i++)
+    {
+        delete m_faces[i];
     }
 }
 
 void SkyBox::render() const
 {
+    ProfileZone zone("SkyBox::render", true);
+
     Matrix modelview;
     glGetFloatv(GL_MODELVIEW_MATRIX, modelview.m);
 
@@ -78,7 +92,7 @@ void SkyBox::render() const
     for (int i = 0; i < 5; i++)
     {
         m_texture[i]->bind();
-        Video::instance->renderFace(m_faces[i]);
+        m_faces[i]->render();
     }
     glEnableClientState(GL_NORMAL_ARRAY);
 
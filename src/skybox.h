@@ -5,17 +5,19 @@
 #include "video.h"
 
 class Texture;
+class Mesh;
 
 class SkyBox : public NoCopy
 {
 public:
     SkyBox(const string& name);
+    ~SkyBox();
 
     void render() const;
 
 private:
-    Texture* m_texture[6];
-    Face     m_faces[6];
+    Texture* m_texture[5];
+    Mesh*    m_faces[5];
 };
 
 #endif
@@ -3,12 +3,19 @@
 #include "sound.h"
 #include "sound_buffer.h"
 #include "config.h"
+#include "loader.h"
 
 Sound::Sound(bool interrupt) : m_interrupt(interrupt)
 {
-    alGenSources(1, &m_source);
-    alSourcef(m_source, AL_GAIN, Config::instance->m_audio.sound_vol/10.0f);
-    alSourcef(m_source, AL_MIN_GAIN, 0.3f * (Config::instance->m_audio.sound_vol/10.0f));
+    Loader::runOnMain(create, this);
+}
+
+void Sound::create(void* sound)
+{
+    Sound* self = static_cast<Sound*>(sound);
+    alGenSources(1, &self->m_source);
+    alSourcef(self->m_source, AL_GAIN, Config::instance->m_audio.sound_vol/10.0f);
+    alSourcef(self->m_source, AL_MIN_GAIN, 0.3f * (Config::instance->m_audio.sound_vol/10.0f));
 }
 
 Sound::~Sound()
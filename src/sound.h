@@ -23,6 +23,8 @@ private:
 
     bool         m_interrupt;
     unsigned int m_source;
+
+    static void create(void* sound); // on main thread
 };
 
 #endif
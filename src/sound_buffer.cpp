@@ -1,24 +1,192 @@
 #include "openal_includes.h"
 
 #include "sound_buffer.h"
+#include "oggDecoder.h"
+#include "file.h"
+#include "loader.h"
+#include "memory_budget.h"
 
-SoundBuffer::SoundBuffer(const string& filename) : OggDecoder("/data/sound/" + filename + ".ogg")
+// decoded sounds are cached in write directory and memory mapped later
+static const string CACHE_DIR = "/cache";
+static const unsigned int CACHE_MAGIC = 0x4D435053; // "SPCM"
+static const unsigned int CACHE_VERSION = 1;
+
+struct SoundCacheHeader
+{
+    unsigned int magic;
+    unsigned int version;
+    unsigned int sourceSize; // cache is invalid when ogg file changes
+    unsigned int sourceTime;
+    unsigned int format;
+    unsigned int frequency;
+    unsigned int size;
+};
+
+static string getSourceName(const string& name)
+{
+    return "/data/sound/" + name + ".ogg";
+}
+
+static string getCacheName(const string& name)
 {
-    size_t bufferSize = totalSize();
+    return CACHE_DIR + "/" + name + ".pcm";
+}
 
-    char* buffer = new char [bufferSize];
+static void getSourceStamp(const string& name, unsigned int& size, unsigned int& time)
+{
+    File::Reader in(getSourceName(name));
+    size = (in.is_open() ? static_cast<unsigned int>(in.size()) : 0);
+    time = static_cast<unsigned int>(File::modified(getSourceName(name)));
+}
 
-    alGenBuffers(1, &m_buffer);
+class SoundDecoder : public OggDecoder
+{
+public:
+    SoundDecoder(const string& filename) : OggDecoder(filename) {}
 
-    size_t written = decode(buffer, bufferSize);
-    if (written != 0)
+    void decodeAll(SoundData& sound)
     {
-        alBufferData(m_buffer, m_format, buffer, static_cast<int>(written), m_frequency);
+        sound.format = m_format;
+        sound.frequency = m_frequency;
+        sound.pcm.resize(totalSize());
+        if (!sound.pcm.empty())
+        {
+            sound.pcm.resize(decode(&sound.pcm[0], sound.pcm.size()));
+        }
     }
-    delete [] buffer;
+};
+
+void decodeSound(SoundData& sound)
+{
+    SoundDecoder(getSourceName(sound.name)).decodeAll(sound);
+}
+
+struct SoundUpload
+{
+    SoundBuffer* buffer;
+    unsigned int format;
+    const char*  pcm;
+    size_t       size;
+    unsigned int frequency;
+};
+
+SoundBuffer::SoundBuffer() : m_buffer(0), m_memory(0)
+{
+}
+
+SoundBuffer::SoundBuffer(const string& filename) : m_buffer(0), m_memory(0)
+{
+    if (loadCache(filename))
+    {
+        return;
+    }
+
+    SoundData sound(filename);
+    decodeSound(sound);
+    upload(sound.format, sound.pcm.empty() ? NULL : &sound.pcm[0], sound.pcm.size(), sound.frequency);
+    saveCache(sound);
+}
+
+SoundBuffer::SoundBuffer(const SoundData& sound) : m_buffer(0), m_memory(0)
+{
+    upload(sound.format, sound.pcm.empty() ? NULL : &sound.pcm[0], sound.pcm.size(), sound.frequency);
+    saveCache(sound);
 }
 
 SoundBuffer::~SoundBuffer()
 {
-    alDeleteBuffers(1, &m_buffer);
+    MemoryBudget::remove(MemoryBudget::Audio, m_memory);
+    if (m_buffer != 0)
+    {
+        alDeleteBuffers(1, &m_buffer);
+    }
+}
+
+SoundBuffer* SoundBuffer::loadCached(const string& filename)
+{
+    SoundBuffer* buffer = new SoundBuffer();
+    if (buffer->loadCache(filename))
+    {
+        return buffer;
+    }
+    delete buffer;
+    return NULL;
+}
+
+bool SoundBuffer::loadCache(const string& filename)
+{
+    File::Mapping cache(getCacheName(filename));
+    if (!cache.is_open() || cache.size() < sizeof(SoundCacheHeader))
+    {
+        return false;
+    }
+
+    unsigned int sourceSize, sourceTime;
+    getSourceStamp(filename, sourceSize, sourceTime);
+
+    const SoundCacheHeader* header = reinterpret_cast<const SoundCacheHeader*>(cache.data());
+    if (header->magic != CACHE_MAGIC || header->version != CACHE_VERSION ||
+        header->sourceSize != sourceSize || header->sourceTime != sourceTime ||
+        header->size != cache.size() - sizeof(SoundCacheHeader))
+    {
+        return false;
+    }
+
+    upload(header->format, cache.data() + sizeof(SoundCacheHeader), header->size, header->frequency);
+    return true;
+}
+
+void SoundBuffer::upload(unsigned int format, const char* pcm, size_t size, unsigned int frequency)
+{
+    SoundUpload data = { this, format, pcm, size, frequency };
+    Loader::runOnMain(create, &data);
+}
+
+void SoundBuffer::create(void* arg)
+{
+    const SoundUpload* data = static_cast<SoundUpload*>(arg);
+
+    alGenBuffers(1, &data->buffer->m_buffer);
+    if (data->size != 0)
+    {
+        alBufferData(data->buffer->m_buffer, data->format, data->pcm, static_cast<int>(data->size), data->frequency);
+    }
+    data->buffer->m_memory = data->size;
+    MemoryBudget::add(MemoryBudget::Audio, data->size);
+}
+
+void SoundBuffer::saveCache(const SoundData& sound) const
+{
+    SoundCacheHeader header;
+    header.magic = CACHE_MAGIC;
+    header.version = CACHE_VERSION;
+    getSourceStamp(sound.name, header.sourceSize, header.sourceTime);
+    header.format = sound.format;
+    header.frequency = sound.frequency;
+    header.size = static_cast<unsigned int>(sound.pcm.size());
+
+    // cache is only optimization, failing to write it is not an error
+    try
+    {
+        if (!File::exists(CACHE_DIR))
+        {
+            File::makeDir(CACHE_DIR);
+        }
+
+        File::Writer out(getCacheName(sound.name));
+        if (!out.is_open())
+        {
+            return;
+        }
+        out.write(&header, sizeof(header));
+        if (!sound.pcm.empty())
+        {
+            out.write(&sound.pcm[0], sound.pcm.size());
+        }
+        out.close();
+    }
+    catch (const string& error)
+    {
+        clog << "Failed to write sound cache for '" << sound.name << "': " << error << endl;
+    }
 }
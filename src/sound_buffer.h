@@ -2,18 +2,43 @@
 #define __SOUND_BUFFER_H__
 
 #include "common.h"
-#include "oggDecoder.h"
 
-class SoundBuffer : public OggDecoder
+// decoded PCM data of sound effect
+struct SoundData
+{
+    SoundData(const string& name) : name(name), format(0), frequency(0) {}
+
+    string        name;
+    unsigned int  format;
+    unsigned int  frequency;
+    vector<char>  pcm;
+    string        error; // decoding in worker thread failed
+};
+
+// decodes whole ogg file, safe to call from worker threads
+void decodeSound(SoundData& sound);
+
+class SoundBuffer : public NoCopy
 {
     friend class Sound;
     friend class Audio;
 
 private:
     SoundBuffer(const string& filename);
+    SoundBuffer(const SoundData& sound);
     ~SoundBuffer();
 
+    // returns NULL if there is no valid decoded cache
+    static SoundBuffer* loadCached(const string& filename);
+
+    SoundBuffer();
+    bool loadCache(const string& filename);
+    void upload(unsigned int format, const char* pcm, size_t size, unsigned int frequency);
+    static void create(void* arg); // on main thread
+    void saveCache(const SoundData& sound) const;
+
     unsigned int m_buffer;
+    size_t       m_memory;
 };
 
 #endif
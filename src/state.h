@@ -16,6 +16,7 @@ public:
         Intro,
         Menu,
         Lobby,
+        Loading,
         World,
         Quit,
     };
@@ -31,6 +32,9 @@ public:
     virtual void render() const = 0;
     virtual State::Type progress() = 0;
 
+    // already initialized state to switch to, instead of creating new one
+    virtual State* next() { return NULL; }
+
 };
 
 #endif
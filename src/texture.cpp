@@ -3,20 +3,54 @@
 #include "file.h"
 #include "vmath.h"
 #include "config.h"
+#include "loader.h"
+#include "memory_budget.h"
 
-Texture::Texture(const string& name, bool mipmaps) : m_size(0)
+struct TextureCreate
 {
-    glGenTextures(1, (GLuint*)&m_handle);
-    glBindTexture(GL_TEXTURE_2D, m_handle);
+    Texture*   texture;
+    GLFWimage* image;
+    bool       mipmaps;
+};
+
+struct TextureParameter
+{
+    const Texture* texture;
+    int            value;
+};
 
+Texture::Texture(const string& name, bool mipmaps) : m_size(0), m_memory(0)
+{
+    // decoding can happen in loader thread
     GLFWimage image;
     loadImage("/data/textures/" + name + ".tga", 0, &image);
-    upload(&image, mipmaps);
     m_size = image.Width;
+
+    // mipmap chain adds one third
+    m_memory = image.Width * image.Height * image.BytesPerPixel;
+    if (mipmaps)
+    {
+        m_memory += m_memory / 3;
+    }
+    MemoryBudget::add(MemoryBudget::Textures, m_memory);
+
+    TextureCreate data = { this, &image, mipmaps };
+    Loader::runOnMain(create, &data);
     glfwFreeImage(&image);
+}
+
+void Texture::create(void* arg)
+{
+    TextureCreate* create = static_cast<TextureCreate*>(arg);
+    Texture* self = create->texture;
 
-    setFilter(Trilinear);
-    setWrap(Repeat);
+    glGenTextures(1, (GLuint*)&self->m_handle);
+    glBindTexture(GL_TEXTURE_2D, self->m_handle);
+
+    self->upload(create->image, create->mipmaps);
+
+    self->setFilter(Trilinear);
+    self->setWrap(Repeat);
 
     if (Config::instance->m_video.anisotropy > 0)
     {
@@ -26,12 +60,22 @@ Texture::Texture(const string& name, bool mipmaps) : m_size(0)
 
 Texture::~Texture()
 {
+    MemoryBudget::remove(MemoryBudget::Textures, m_memory);
     glDeleteTextures(1, (GLuint*)&m_handle);
 }
 
 void Texture::setFilter(const FilterType filter)
 {
-    switch (filter)
+    TextureParameter parameter = { this, filter };
+    Loader::runOnMain(applyFilter, &parameter);
+}
+
+void Texture::applyFilter(void* arg)
+{
+    const TextureParameter* parameter = static_cast<TextureParameter*>(arg);
+    parameter->texture->bind();
+
+    switch (parameter->value)
     {
     case None:
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -50,7 +94,16 @@ void Texture::setFilter(const FilterType filter)
 
 void Texture::setWrap(const WrapType wrap)
 {
-    switch (wrap)
+    TextureParameter parameter = { this, wrap };
+    Loader::runOnMain(applyWrap, &parameter);
+}
+
+void Texture::applyWrap(void* arg)
+{
+    const TextureParameter* parameter = static_cast<TextureParameter*>(arg);
+    parameter->texture->bind();
+
+    switch (parameter->value)
     {
     case Repeat:
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -74,18 +127,13 @@ void Texture::bind() const
 
 void Texture::loadImage(const string& filename, int flags, GLFWimage* image) const
 {
-    File::Reader file(filename);
+    File::Contents file(filename);
     if (!file.is_open())
     {
         throw Exception("Texture '" + filename + "' not found");
     }
-    size_t filesize = file.size();
-
-    vector<char> data(filesize);
-    file.read(&data[0], filesize);
-    file.close();
 
-    glfwReadMemoryImage(&data[0], static_cast<int>(filesize), image, flags);
+    glfwReadMemoryImage(file.data(), static_cast<int>(file.size()), image, flags);
 }
 
 void Texture::upload(GLFWimage* image, bool mipmaps) const
@@ -33,6 +33,12 @@ protected:
 
 private:
     unsigned int m_handle;
+    size_t       m_memory;
+
+    // OpenGL part, always executed on main thread
+    static void create(void* arg);
+    static void applyFilter(void* arg);
+    static void applyWrap(void* arg);
 };
 
 #endif
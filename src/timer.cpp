@@ -2,6 +2,30 @@
 
 #include "timer.h"
 
+static bool  simulated = false;
+static float simulatedTime = 0.0f;
+
+static float now()
+{
+    return simulated ? simulatedTime : static_cast<float>(glfwGetTime());
+}
+
+void Timer::setSimulated(bool enabled)
+{
+    simulated = enabled;
+    simulatedTime = 0.0f;
+}
+
+void Timer::advance(float delta)
+{
+    simulatedTime += delta;
+}
+
+double Timer::precise()
+{
+    return glfwGetTime();
+}
+
 Timer::Timer(bool start) :
     m_running(start ? 1 : 0),
     m_elapsed(0.0f),
@@ -18,7 +42,7 @@ void Timer::pause()
         return;
     }
 
-    m_elapsed += static_cast<float>(glfwGetTime()) - m_resumed;
+    m_elapsed += now() - m_resumed;
 }
 
 void Timer::resume()
@@ -29,7 +53,7 @@ void Timer::resume()
         return;
     }
 
-    m_resumed = static_cast<float>(glfwGetTime());
+    m_resumed = now();
 }
 
 void Timer::reset(bool start)
@@ -37,7 +61,7 @@ void Timer::reset(bool start)
     m_running = (start ? 1 : 0);
     if (start)
     {
-        m_resumed = static_cast<float>(glfwGetTime());
+        m_resumed = now();
     }
     m_elapsed = 0;
 }
@@ -48,5 +72,5 @@ float Timer::read() const
     {
         return m_elapsed;
     }
-    return static_cast<float>(glfwGetTime()) - m_resumed + m_elapsed;
+    return now() - m_resumed + m_elapsed;
 }
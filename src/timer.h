@@ -14,6 +14,13 @@ public:
 
     float read() const;
 
+    // all timers follow simulated clock instead of real time
+    static void setSimulated(bool enabled);
+    static void advance(float delta);
+
+    // real time in seconds with best available resolution, never simulated
+    static double precise();
+
 private:
     int    m_running;
     float  m_elapsed;
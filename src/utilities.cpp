@@ -1,5 +1,8 @@
 #include <ctime>
 #include <cctype>
+#include <climits>
+#include <cfloat>
+#include <cstdlib>
 
 #include "utilities.h"
 
@@ -40,3 +43,158 @@ string trim(const string& str)
     }
     return str.substr(i, j-i+1);
 }
+
+// exact in double, mantissa exact in double (up to 2^53) scaled by one
+// of them is correctly rounded double, it is then rounded to float
+static const double POWERS_OF_TEN[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+static const int MAX_POWER_OF_TEN = 22;
+static const int MAX_DIGITS = 18; // fits in unsigned long long
+static const unsigned long long MAX_EXACT_MANTISSA = 1ULL << 53;
+
+static const char* parseSign(const char* str, bool& negative)
+{
+    negative = (*str == '-');
+    if (*str == '-' || *str == '+')
+    {
+        str++;
+    }
+    return str;
+}
+
+bool parseNumber(const char* str, float& value)
+{
+    bool negative;
+    const char* s = parseSign(str, negative);
+
+    unsigned long long mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool any = false;
+
+    for (; *s >= '0' && *s <= '9'; s++, any = true)
+    {
+        if (digits < MAX_DIGITS)
+        {
+            mantissa = mantissa * 10 + (*s - '0');
+            digits += (mantissa != 0);
+        }
+        else
+        {
+            exponent++;
+        }
+    }
+    if (*s == '.')
+    {
+        for (s++; *s >= '0' && *s <= '9'; s++, any = true)
+        {
+            if (digits < MAX_DIGITS)
+            {
+                mantissa = mantissa * 10 + (*s - '0');
+                digits += (mantissa != 0);
+                exponent--;
+            }
+        }
+    }
+    if (!any)
+    {
+        return false;
+    }
+
+    if (*s == 'e' || *s == 'E')
+    {
+        bool negativeExp;
+        s = parseSign(s + 1, negativeExp);
+        if (*s < '0' || *s > '9')
+        {
+            return false;
+        }
+        int e = 0;
+        for (; *s >= '0' && *s <= '9'; s++)
+        {
+            if (e < 1000)
+            {
+                e = e * 10 + (*s - '0');
+            }
+        }
+        exponent += (negativeExp ? -e : e);
+    }
+    if (*s != 0)
+    {
+        return false;
+    }
+
+    double result = static_cast<double>(mantissa);
+    if (mantissa != 0)
+    {
+        if (mantissa > MAX_EXACT_MANTISSA || exponent < -MAX_POWER_OF_TEN || exponent > MAX_POWER_OF_TEN)
+        {
+            // rare, leave it to C library, out of float range is not a number
+            result = strtod(str, NULL);
+            if (result > FLT_MAX || result < -FLT_MAX)
+            {
+                return false;
+            }
+            value = static_cast<float>(result);
+            return true;
+        }
+        if (exponent < 0)
+        {
+            result /= POWERS_OF_TEN[-exponent];
+        }
+        else
+        {
+            result *= POWERS_OF_TEN[exponent];
+        }
+    }
+    value = static_cast<float>(negative ? -result : result);
+    return true;
+}
+
+bool parseNumber(const char* str, int& value)
+{
+    bool negative;
+    const char* s = parseSign(str, negative);
+    if (*s == 0)
+    {
+        return false;
+    }
+
+    const unsigned int limit = (negative ? static_cast<unsigned int>(INT_MAX) + 1 : INT_MAX);
+    unsigned int result = 0;
+    for (; *s != 0; s++)
+    {
+        if (*s < '0' || *s > '9' || result > (limit - (*s - '0')) / 10)
+        {
+            return false;
+        }
+        result = result * 10 + (*s - '0');
+    }
+
+    value = (negative ? static_cast<int>(0u - result) : static_cast<int>(result));
+    return true;
+}
+
+bool parseNumber(const char* str, unsigned int& value)
+{
+    const char* s = (*str == '+' ? str + 1 : str);
+    if (*s == 0)
+    {
+        return false;
+    }
+
+    unsigned int result = 0;
+    for (; *s != 0; s++)
+    {
+        if (*s < '0' || *s > '9' || result > (UINT_MAX - (*s - '0')) / 10)
+        {
+            return false;
+        }
+        result = result * 10 + (*s - '0');
+    }
+
+    value = result;
+    return true;
+}
@@ -6,4 +6,10 @@
 string getDateTime();
 string trim(const string& str);
 
+// locale independent and without allocations, whole string must be
+// plain decimal number, otherwise returns false and value is unchanged
+bool parseNumber(const char* str, float& value);
+bool parseNumber(const char* str, int& value);
+bool parseNumber(const char* str, unsigned int& value);
+
 #endif
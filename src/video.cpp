@@ -10,6 +10,11 @@
 
 static const int CIRCLE_DIVISIONS = 12;
 
+// rgba + xyz
+static const int SHADOW_VERTEX_SIZE = 7;
+// how far object can move before its shadow is projected on ground again
+static const float SHADOW_CACHE_DISTANCE = 0.02f;
+
 template <class Video> Video* System<Video>::instance = NULL;
 
 static void GLFWCALL sizeCb(int width, int height)
@@ -19,14 +24,13 @@ static void GLFWCALL sizeCb(int width, int height)
     glMatrixMode(GL_PROJECTION);
     glLoadIdentity();
 
-    const float fov = 45.0f;
     const float aspect = static_cast<float>(width)/static_cast<float>(height);
-    const float top = std::tan(fov/2 * DEG_IN_RAD) * 0.1f;
+    const float top = std::tan(CAMERA_FOV/2 * DEG_IN_RAD) * CAMERA_NEAR;
     const float bottom = -top;
     const float left = aspect * bottom;
     const float right = aspect * top;
 
-    glFrustum(left, right, bottom, top, 0.1, 102.4);
+    glFrustum(left, right, bottom, top, CAMERA_NEAR, CAMERA_FAR);
 
     glMatrixMode(GL_MODELVIEW);
     glLoadIdentity();
@@ -51,7 +55,11 @@ Video::Video() :
     m_haveShadows(false),
     m_haveFBO(false),
     m_haveVBO(false),
-    m_haveShaders(false)
+    m_haveShaders(false),
+    m_uiBuffer(0),
+    m_uiBufferSize(0),
+    m_shadowBuffer(0),
+    m_shadowBufferSize(0)
 {
     setInstance(this);
 
@@ -166,6 +174,15 @@ Video::~Video()
     }
     m_lists.clear();
 
+    if (m_uiBuffer != 0)
+    {
+        glDeleteBuffersARB(1, (GLuint*)&m_uiBuffer);
+    }
+    if (m_shadowBuffer != 0)
+    {
+        glDeleteBuffersARB(1, (GLuint*)&m_shadowBuffer);
+    }
+
     glfwCloseWindow();
 #ifndef __APPLE__
     video_finish();
@@ -455,78 +472,322 @@ void Video::unloadTextures()
     m_textures.clear();
 }
 
-void Video::renderRoundRect(const Vector& lower, const Vector& upper, float r) const
+void Video::renderRect(const Vector& lower, const Vector& upper)
 {
-    glDisable(GL_TEXTURE_2D);
-    glBegin(GL_POLYGON);
-        for (int i=0; i<9; i++)
+    const Vector corners[] = {
+        Vector(lower.x, lower.y, 0.0f),
+        Vector(upper.x, lower.y, 0.0f),
+        Vector(upper.x, upper.y, 0.0f),
+        Vector(lower.x, upper.y, 0.0f),
+    };
+    static const int order[] = { 0, 1, 2, 0, 2, 3 };
+
+    Matrix transform;
+    unsigned char color[4];
+    getUIState(transform, color);
+
+    UIVertex* v = addUIVertices(0, sizeOfArray(order));
+    for (size_t i=0; i<sizeOfArray(order); i++, v++)
+    {
+        const Vector p = transform * corners[order[i]];
+        v->u = v->v = 0.0f;
+        std::copy(color, color+4, v->color);
+        v->x = p.x;
+        v->y = p.y;
+        v->z = 0.0f;
+    }
+}
+
+void Video::renderRoundRect(const Vector& lower, const Vector& upper, float r)
+{
+    // outline of rectangle with rounded corners, corners have 9 points each
+    static const int CORNER = 9;
+    Vector outline[4*CORNER];
+    for (int i=0; i<CORNER; i++)
+    {
+        const float s1 = r*std::sin(i*M_PI_2/8);
+        const float c1 = r*std::cos(i*M_PI_2/8);
+        const float s2 = r*std::sin((8-i)*M_PI_2/8);
+        const float c2 = r*std::cos((8-i)*M_PI_2/8);
+        outline[0*CORNER + i] = Vector(lower.x - s1, lower.y - c1, 0.0f);
+        outline[1*CORNER + i] = Vector(lower.x - s2, upper.y + c2, 0.0f);
+        outline[2*CORNER + i] = Vector(upper.x + s1, upper.y + c1, 0.0f);
+        outline[3*CORNER + i] = Vector(upper.x + s2, lower.y - c2, 0.0f);
+    }
+
+    Matrix transform;
+    unsigned char color[4];
+    getUIState(transform, color);
+
+    // convex, so triangle fan from first point
+    const int count = 4*CORNER - 2;
+    UIVertex* v = addUIVertices(0, 3*count);
+    for (int i=0; i<count; i++)
+    {
+        const Vector* tri[] = { &outline[0], &outline[i+1], &outline[i+2] };
+        for (int k=0; k<3; k++, v++)
+        {
+            const Vector p = transform * *tri[k];
+            v->u = v->v = 0.0f;
+            std::copy(color, color+4, v->color);
+            v->x = p.x;
+            v->y = p.y;
+            v->z = 0.0f;
+        }
+    }
+}
+
+UIVertex* Video::addUIVertices(unsigned int texture, size_t count)
+{
+    const size_t first = m_uiVertices.size();
+    m_uiVertices.resize(first + count);
+
+    if (m_uiRanges.empty() || m_uiRanges.back().texture != texture)
+    {
+        UIRange range = { texture, first, 0 };
+        m_uiRanges.push_back(range);
+    }
+    m_uiRanges.back().count += count;
+
+    return &m_uiVertices[first];
+}
+
+void Video::getUIState(Matrix& transform, unsigned char color[4]) const
+{
+    glGetFloatv(GL_MODELVIEW_MATRIX, transform.m);
+
+    Vector current;
+    glGetFloatv(GL_CURRENT_COLOR, current.v);
+    for (int i=0; i<4; i++)
+    {
+        color[i] = static_cast<unsigned char>(std::min(std::max(current.v[i], 0.0f), 1.0f) * 255.0f + 0.5f);
+    }
+}
+
+void Video::flushUI()
+{
+    if (m_uiVertices.empty())
+    {
+        return;
+    }
+
+    glPushAttrib(
+        GL_COLOR_BUFFER_BIT |
+        GL_CURRENT_BIT |
+        GL_DEPTH_BUFFER_BIT |
+        GL_ENABLE_BIT |
+        GL_LIGHTING_BIT |
+        GL_TEXTURE_BIT |
+        GL_TRANSFORM_BIT |
+        GL_POLYGON_BIT);
+    glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+
+    int viewport[4];
+    glGetIntegerv(GL_VIEWPORT, (GLint*)viewport);
+
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glOrtho(viewport[0], viewport[2], viewport[1], viewport[3], -1.0f, 1.0f);
+
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+
+    glDisable(GL_LIGHTING);
+    glDisable(GL_DEPTH_TEST);
+    glDepthMask(GL_FALSE);
+    glDisable(GL_CULL_FACE);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    const size_t size = m_uiVertices.size() * sizeof(UIVertex);
+    const char* data = reinterpret_cast<const char*>(&m_uiVertices[0]);
+
+    if (m_haveVBO)
+    {
+        if (m_uiBuffer == 0)
         {
-            glVertex2f(lower.x - r*std::sin(i*M_PI_2/8), lower.y - r*std::cos(i*M_PI_2/8));
+            glGenBuffersARB(1, (GLuint*)&m_uiBuffer);
         }
-        for (int i=0; i<9; i++)
+        glBindBufferARB(GL_ARRAY_BUFFER_ARB, m_uiBuffer);
+        if (size > m_uiBufferSize)
         {
-            glVertex2f(lower.x - r*std::sin((8-i)*M_PI_2/8), upper.y + r*std::cos((8-i)*M_PI_2/8));
+            m_uiBufferSize = size;
         }
-        for (int i=0; i<9; i++)
+        glBufferDataARB(GL_ARRAY_BUFFER_ARB, m_uiBufferSize, NULL, GL_STREAM_DRAW_ARB);
+        glBufferSubDataARB(GL_ARRAY_BUFFER_ARB, 0, size, data);
+        data = NULL;
+    }
+
+    glInterleavedArrays(GL_T2F_C4UB_V3F, sizeof(UIVertex), data);
+
+    for each_const(UIRanges, m_uiRanges, iter)
+    {
+        if (iter->texture == 0)
         {
-            glVertex2f(upper.x + r*std::sin(i*M_PI_2/8), upper.y + r*std::cos(i*M_PI_2/8));
+            glDisable(GL_TEXTURE_2D);
         }
-        for (int i=0; i<9; i++)
+        else
         {
-            glVertex2f(upper.x + r*std::sin((8-i)*M_PI_2/8), lower.y - r*std::cos((8-i)*M_PI_2/8));
+            glEnable(GL_TEXTURE_2D);
+            glBindTexture(GL_TEXTURE_2D, iter->texture);
         }
-    glEnd();
-    glEnable(GL_TEXTURE_2D);
+        glDrawArrays(GL_TRIANGLES, static_cast<GLint>(iter->first), static_cast<GLsizei>(iter->count));
+    }
+
+    if (m_haveVBO)
+    {
+        glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0);
+    }
+
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+    glPopMatrix();
+
+    glPopClientAttrib();
+    glPopAttrib();
+
+    m_uiVertices.clear();
+    m_uiRanges.clear();
 }
 
-void Video::renderSimpleShadow(float r, const Vector& pos, const Collision* level, const Vector& color) const
+void Video::addSimpleShadow(const void* owner, float r, const Vector& pos, const Collision* level, const Vector& color)
 {
-    if (Config::instance->m_video.use_hdr)
+    level->renderTri(pos.x, pos.z);
+
+    SimpleShadow& shadow = m_shadowCache[owner];
+    shadow.used = true;
+
+    // ground under shadow is sampled again only when object has moved enough
+    const float dx = pos.x - shadow.pos.x;
+    const float dz = pos.z - shadow.pos.z;
+    if (shadow.heights.empty() || shadow.level != level || shadow.r != r ||
+        dx*dx + dz*dz > SHADOW_CACHE_DISTANCE*SHADOW_CACHE_DISTANCE)
     {
-        glEnable(GL_POLYGON_OFFSET_FILL);
-        glPolygonOffset(-1.0f, -1.5f);
+        float y = 0.01f;
+
+        if (isPointInRectangle(pos, Vector(-3, 0, -3), Vector(3, 0, 3)))
+        {
+            y += 0.005f;
+        }
+
+        shadow.level = level;
+        shadow.r = r;
+        shadow.pos = pos;
+        shadow.heights.resize(CIRCLE_DIVISIONS + 2);
+        shadow.heights[0] = level->getHeight(pos.x, pos.z) + y;
+        for (int i=0; i<=CIRCLE_DIVISIONS; i++)
+        {
+            shadow.heights[i+1] = level->getHeight(pos.x + r * m_circleCos[i], pos.z + r * m_circleSin[i]) + y;
+        }
     }
-            
-    float y = 0.01f;
 
-    if (isPointInRectangle(pos, Vector(-3, 0, -3), Vector(3, 0, 3)))
+    // fan is stored as separate triangles, so all shadows go in one draw call
+    const Vector& p = shadow.pos;
+    for (int i=0; i<CIRCLE_DIVISIONS; i++)
     {
-        y += 0.005f;
+        const float v[] = {
+            color.x, color.y, color.z, color.w,
+            p.x, shadow.heights[0], p.z,
+
+            color.x, color.y, color.z, color.w - 0.1f,
+            p.x + r * m_circleCos[i], shadow.heights[i+1], p.z + r * m_circleSin[i],
+
+            color.x, color.y, color.z, color.w - 0.1f,
+            p.x + r * m_circleCos[i+1], shadow.heights[i+2], p.z + r * m_circleSin[i+1],
+        };
+        m_shadowVertices.insert(m_shadowVertices.end(), v, v + sizeOfArray(v));
     }
+}
 
-    glPushMatrix();
+void Video::renderSimpleShadows()
+{
+    // owners that didn't add shadow this frame are gone or hidden,
+    // their address can be reused by new object
+    for (SimpleShadowMap::iterator iter = m_shadowCache.begin(); iter != m_shadowCache.end(); )
+    {
+        if (iter->second.used)
+        {
+            iter->second.used = false;
+            ++iter;
+        }
+        else
+        {
+            m_shadowCache.erase(iter++);
+        }
+    }
+
+    if (m_shadowVertices.empty())
+    {
+        return;
+    }
+
+    if (Config::instance->m_video.use_hdr)
+    {
+        glEnable(GL_POLYGON_OFFSET_FILL);
+        glPolygonOffset(-1.0f, -1.5f);
+    }
 
     glPushAttrib(GL_CURRENT_BIT | GL_ENABLE_BIT | GL_LIGHTING_BIT | GL_COLOR_BUFFER_BIT);
+    glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
 
     glDisable(GL_LIGHTING);
     glDisable(GL_TEXTURE_2D);
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    level->renderTri(pos.x, pos.z);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
 
-    glBegin(GL_TRIANGLE_FAN);
-    
-    glColor4fv(color.v);
-    float yy = level->getHeight(pos.x, pos.z) + y;
-    glVertex3f(pos.x, yy, pos.z);
+    const size_t size = m_shadowVertices.size() * sizeof(float);
+    const GLsizei stride = SHADOW_VERTEX_SIZE * sizeof(float);
+    const GLsizei count = static_cast<GLsizei>(m_shadowVertices.size() / SHADOW_VERTEX_SIZE);
 
-    glColor4fv(Vector(color.x, color.y, color.z, color.w-0.1f).v);
-    for (int i=0; i<=CIRCLE_DIVISIONS; i++)
+    if (m_haveVBO)
     {
-        float xx = r * m_circleCos[i];
-        float zz = r * m_circleSin[i];
-        float yy = level->getHeight(pos.x+xx, pos.z+zz) + y;
-        glVertex3f(pos.x + xx, yy, pos.z + zz);
+        if (m_shadowBuffer == 0)
+        {
+            glGenBuffersARB(1, (GLuint*)&m_shadowBuffer);
+        }
+        glBindBufferARB(GL_ARRAY_BUFFER_ARB, m_shadowBuffer);
+        if (size > m_shadowBufferSize)
+        {
+            m_shadowBufferSize = size;
+        }
+        // orphan previous frame data, driver doesn't need to wait for it
+        glBufferDataARB(GL_ARRAY_BUFFER_ARB, m_shadowBufferSize, NULL, GL_STREAM_DRAW_ARB);
+        glBufferSubDataARB(GL_ARRAY_BUFFER_ARB, 0, size, &m_shadowVertices[0]);
+
+        glColorPointer(4, GL_FLOAT, stride, NULL);
+        glVertexPointer(3, GL_FLOAT, stride, (char*)NULL + 4 * sizeof(float));
+        glDrawArrays(GL_TRIANGLES, 0, count);
+
+        glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0);
+    }
+    else
+    {
+        glColorPointer(4, GL_FLOAT, stride, &m_shadowVertices[0]);
+        glVertexPointer(3, GL_FLOAT, stride, &m_shadowVertices[4]);
+        glDrawArrays(GL_TRIANGLES, 0, count);
     }
 
-    glEnd();
+    glPopClientAttrib();
     glPopAttrib();
 
-    glPopMatrix();
-
     if (Config::instance->m_video.use_hdr)
     {
         glDisable(GL_POLYGON_OFFSET_FILL);
     }
+
+    m_shadowVertices.clear();
+}
+
+void Video::clearSimpleShadows()
+{
+    m_shadowCache.clear();
+    m_shadowVertices.clear();
 }
@@ -16,6 +16,11 @@ class Material;
 class Texture;
 class Collision;
 
+// perspective projection of 3D scene
+static const float CAMERA_FOV = 45.0f;
+static const float CAMERA_NEAR = 0.1f;
+static const float CAMERA_FAR = 102.4f;
+
 struct UV
 {
     UV(float u = 0.0f, float v = 0.0f) : u(u), v(v) {}
@@ -30,7 +35,37 @@ struct Face
     vector<Vector> vertexes;
 };
 
+// cached ground heights of one blob shadow
+struct SimpleShadow
+{
+    const Collision* level;
+    float            r;
+    Vector           pos;
+    vector<float>    heights;
+    bool             used; // added since last renderSimpleShadows
+};
+
+// screen space vertex of 2D user interface batch
+struct UIVertex
+{
+    float         u, v;
+    unsigned char color[4];
+    float         x, y, z;
+};
+
+// vertices drawn with same texture, 0 for untextured
+struct UIRange
+{
+    unsigned int texture;
+    size_t       first;
+    size_t       count;
+};
+
+typedef vector<UIVertex> UIVertices;
+typedef vector<UIRange> UIRanges;
+
 typedef map<string, Texture*> TextureMap;
+typedef map<const void*, SimpleShadow> SimpleShadowMap;
 
 void video_setup();
 void video_finish();
@@ -46,8 +81,16 @@ public:
 
     void renderFace(const Face& face) const;
     void renderAxes(float size = 5.0f) const;
-    void renderRoundRect(const Vector& lower, const Vector& upper, float r) const;
-    void renderSimpleShadow(float r, const Vector& pos, const Collision* level, const Vector& color) const;
+    void renderRect(const Vector& lower, const Vector& upper);
+    void renderRoundRect(const Vector& lower, const Vector& upper, float r);
+    void addSimpleShadow(const void* owner, float r, const Vector& pos, const Collision* level, const Vector& color);
+    void renderSimpleShadows();
+    void clearSimpleShadows();
+
+    // 2D geometry is collected in one streaming buffer and drawn by flushUI in submission order
+    UIVertex* addUIVertices(unsigned int texture, size_t count);
+    void getUIState(Matrix& transform, unsigned char color[4]) const;
+    void flushUI();
 
     void begin() const;
     void begin(const Matrix& matrix) const;
@@ -78,6 +121,16 @@ private:
 
     vector<float> m_circleSin;
     vector<float> m_circleCos;
+
+    UIVertices      m_uiVertices;
+    UIRanges        m_uiRanges;
+    unsigned int    m_uiBuffer;
+    size_t          m_uiBufferSize;
+
+    SimpleShadowMap m_shadowCache;
+    vector<float>   m_shadowVertices;
+    unsigned int    m_shadowBuffer;
+    size_t          m_shadowBufferSize;
 };
 
 #endif
@@ -32,12 +32,28 @@
 #include "hdr.h"
 #include "chat.h"
 #include "shader.h"
+#include "loader.h"
+#include "profiler.h"
+#include "benchmark.h"
+#include "memory_budget.h"
 
 static const float OBJECT_BRIGHTNESS_1 = 0.5f; // shadowed
 static const float OBJECT_BRIGHTNESS_2 = 0.6f; // lit
 static const float GRASS_BRIGHTNESS_1 = 0.5f; // shadowed
 static const float GRASS_BRIGHTNESS_2 = 0.5f; // lit
 
+// cascades cover camera frustum up to this distance
+static const float SHADOW_DISTANCE = 64.0f;
+// 0 - uniform splits, 1 - logarithmic splits
+static const float SHADOW_SPLIT_LAMBDA = 0.75f;
+// light space box of whole level, cascades are clipped to it
+static const float SHADOW_LEFT = -40.0f;
+static const float SHADOW_RIGHT = 28.0f;
+static const float SHADOW_BOTTOM = -15.0f;
+static const float SHADOW_TOP = 26.0f;
+static const float SHADOW_NEAR = 2.0f;
+static const float SHADOW_FAR = 70.0f;
+
 static const Vector playerPositions[4] = {Vector(- FIELD_LENGTH / 2, 1.5f, - FIELD_LENGTH / 2),
                                           Vector(- FIELD_LENGTH / 2, 1.5f,   FIELD_LENGTH / 2),
                                           Vector(  FIELD_LENGTH / 2, 1.5f,   FIELD_LENGTH / 2),
@@ -46,6 +62,32 @@ static const Vector playerPositions[4] = {Vector(- FIELD_LENGTH / 2, 1.5f, - FIE
 
 template <class World> World* System<World>::instance = NULL;
 
+static Matrix makeOrtho(float left, float right, float bottom, float top, float zNear, float zFar)
+{
+    return Matrix(2.0f / (right - left), 0.0f, 0.0f, 0.0f,
+                  0.0f, 2.0f / (top - bottom), 0.0f, 0.0f,
+                  0.0f, 0.0f, -2.0f / (zFar - zNear), 0.0f,
+                  -(right + left) / (right - left), 
+                  -(top + bottom) / (top - bottom),
+                  -(zFar + zNear) / (zFar - zNear),
+                  1.0f);
+}
+
+// camera matrix is rotation (with mirrored z) and translation only
+static Matrix invertRigid(const Matrix& mx)
+{
+    Matrix result = mx;
+    std::swap(result.m01, result.m10);
+    std::swap(result.m02, result.m20);
+    std::swap(result.m12, result.m21);
+    result.m03 = result.m13 = result.m23 = 0.0f;
+    result.m30 = -(mx.m00*mx.m30 + mx.m01*mx.m31 + mx.m02*mx.m32);
+    result.m31 = -(mx.m10*mx.m30 + mx.m11*mx.m31 + mx.m12*mx.m32);
+    result.m32 = -(mx.m20*mx.m30 + mx.m21*mx.m31 + mx.m22*mx.m32);
+    result.m33 = 1.0f;
+    return result;
+}
+
 State::Type World::progress()
 {
     // TODO: move key reading to update
@@ -193,7 +235,7 @@ State::Type World::progress()
     return State::Current;
 }
 
-World::World(Profile* userProfile, int& unlockable, int current) :
+World::World(Profile* userProfile, int& unlockable, int current, bool headless) :
     m_camera(NULL),
     m_skybox(NULL),
     m_grass(NULL),
@@ -204,6 +246,7 @@ World::World(Profile* userProfile, int& unlockable, int current) :
     m_messages(NULL),
     m_scoreBoard(NULL),
     m_freeze(false),
+    m_headless(headless),
     m_userProfile(userProfile),
     m_escMessage(NULL),
     m_framebuffer(NULL),
@@ -217,6 +260,11 @@ World::World(Profile* userProfile, int& unlockable, int current) :
 {
     setInstance(this); // MUST go first
 
+    if (m_headless)
+    {
+        return;
+    }
+
     m_framebuffer = new FrameBuffer();
 
     m_chat = new Chat(m_userProfile->m_name, m_userProfile->m_color);
@@ -231,6 +279,12 @@ World::World(Profile* userProfile, int& unlockable, int current) :
 }
 
 void World::init()
+{
+    load();
+    start();
+}
+
+void World::load()
 {
     if (m_newtonWorld != NULL)
     {
@@ -269,45 +323,52 @@ void World::init()
     m_messages = new Messages();
     m_scoreBoard = new ScoreBoard(m_messages);
 
-    m_newtonWorld = NewtonCreate(NULL, NULL);
+    m_newtonWorld = NewtonCreate(MemoryBudget::newtonAlloc, MemoryBudget::newtonFree);
 
     // enable some Newton optimization
     NewtonSetSolverModel(m_newtonWorld, 1);
     
     m_level = new Level();
 
-    StringSet tmp;
-    if (Network::instance->m_isSingle)
+    if (!g_benchmarkLevel.empty())
     {
-        m_level->load( ( m_current < 3 ? "world.xml" : "extra.xml" ), tmp);
+        m_level->load(g_benchmarkLevel);
+    }
+    else if (Network::instance->m_isSingle)
+    {
+        m_level->load( m_current < 3 ? "world.xml" : "extra.xml" );
     }
     else
     {
-        m_level->load( Network::instance->getLevel(), tmp);
+        m_level->load( Network::instance->getLevel() );
     }
-    m_grass = new Grass(m_level);
-    
     if (m_level->m_fences.empty() == false)
     {
         makeFence(m_level, m_newtonWorld);
     }
+    Loader::setProgress(0.6f);
 
-    m_skybox = new SkyBox(m_level->m_skyboxName);
-    m_hdr->updateFromLevel(m_level->m_hdr_eps, m_level->m_hdr_exp, m_level->m_hdr_mul);
+    if (!m_headless)
+    {
+        m_grass = new Grass(m_level);
+        Loader::setProgress(0.8f);
+        m_skybox = new SkyBox(m_level->m_skyboxName);
+    }
+    Loader::setProgress(0.9f);
 
-    NewtonBodySetContinuousCollisionMode(m_level->getBody("football")->m_newtonBody, 1);
+    NewtonBodySetContinuousCollisionMode(m_level->m_football->m_newtonBody, 1);
 
     const vector<Player*>& players = Network::instance->createPlayers(m_level);
 
     m_localPlayers = players;
 
-    m_ball = new Ball(m_level->getBody("football"), m_level->m_collisions["level"]);
+    m_ball = new Ball(m_level->m_football, m_level->m_collisions["level"]);
 
     if (Network::instance->m_isSingle || Network::instance->m_isServer)
     {
         m_referee = new RefereeLocal(m_messages, m_scoreBoard);
-        m_referee->m_field = m_level->getBody("field"); //referee now can recognize game field
-        m_referee->m_ground = m_level->getBody("level");; //referee now can recognize ground outside
+        m_referee->m_field = m_level->m_field; //referee now can recognize game field
+        m_referee->m_ground = m_level->m_ground; //referee now can recognize ground outside
         
         //this is for correct registering when waiting for ball bounce in referee
         //it is handled specifically in Ball OnCollide
@@ -316,7 +377,10 @@ void World::init()
 
         m_referee->registerBall(m_ball);
 
-        m_referee->m_humanPlayer = players[Network::instance->getLocalIdx()];
+        if (Network::instance->getLocalIdx() >= 0)
+        {
+            m_referee->m_humanPlayer = players[Network::instance->getLocalIdx()];
+        }
     }
     else
     {
@@ -346,8 +410,8 @@ void World::init()
             net->add((*iter)->m_body);
         }
 
-        net->add(m_level->getBody("field"));
-        net->add(m_level->getBody("level"));
+        net->add(m_level->m_field);
+        net->add(m_level->m_ground);
 
         NewtonBodySetMassMatrix(m_level->getBody("seat")->m_newtonBody, 0, 0, 0, 0);
         NewtonBodySetMassMatrix(m_level->getBody("cucumberFan1")->m_newtonBody, 0, 0, 0, 0);
@@ -356,8 +420,17 @@ void World::init()
     }
 
     m_scoreBoard->reset();
+    Loader::setProgress(1.0f);
+}
+
+void World::start()
+{
+    if (!m_headless)
+    {
+        m_hdr->updateFromLevel(m_level->m_hdr_eps, m_level->m_hdr_exp, m_level->m_hdr_mul);
+    }
 
-    if (!m_level->m_music.empty())
+    if (!m_headless && !m_level->m_music.empty())
     {
         m_level->m_music[Randoms::getIntN(static_cast<unsigned int>(m_level->m_music.size()))]->play();
     }
@@ -379,7 +452,10 @@ void World::init()
         m_messages->add2D(m_waitMessage);    
     }
 
-    m_referee->m_sound->play(m_referee->m_soundGameStart);
+    if (!m_headless)
+    {
+        m_referee->m_sound->play(m_referee->m_soundGameStart);
+    }
 
     float angleAdjust = Network::instance->getLocalIdx() * 90.0f;
     m_camera = new Camera(Vector(0.0f, 1.0f, 12.0f), 20.0f, 0.0f + angleAdjust);
@@ -393,7 +469,11 @@ World::~World()
     
     // -NETWORK
 
-    killShadowStuff();
+    if (!m_headless)
+    {
+        killShadowStuff();
+        Video::instance->clearSimpleShadows();
+    }
     delete m_framebuffer;
     if (m_grass != NULL)
     {
@@ -419,12 +499,24 @@ World::~World()
     delete m_skybox;
     delete m_camera;
     
-    Input::instance->endCharBuffer();
-    Input::instance->endKeyBuffer();
+    if (!m_headless)
+    {
+        Input::instance->endCharBuffer();
+        Input::instance->endKeyBuffer();
+    }
 }
 
 void World::control()
 {
+    if (m_headless)
+    {
+        for (size_t i=0; i<m_localPlayers.size(); i++)
+        {
+            m_localPlayers[i]->control();
+        }
+        return;
+    }
+
     if (glfwGetWindowParam(GLFW_ACTIVE) == GL_TRUE)
     {
         // only camera and local players
@@ -453,7 +545,10 @@ void World::control()
 void World::updateStep(float delta)
 {
     // updateStep is called more than one time in frame
-    m_level->m_properties->update();
+    {
+        ProfileZone zone("Properties::update");
+        m_level->m_properties->update();
+    }
     //
 
     if (Network::instance->m_isSingle == false && Network::instance->m_isServer == false)
@@ -463,9 +558,12 @@ void World::updateStep(float delta)
 
     if (!m_freeze)
     {
-        m_ball->triggerBegin();
-        NewtonUpdate(m_newtonWorld, delta);
-        m_ball->triggerEnd();
+        {
+            ProfileZone zone("NewtonUpdate");
+            m_ball->triggerBegin();
+            NewtonUpdate(m_newtonWorld, delta);
+            m_ball->triggerEnd();
+        }
 
         for (size_t i=0; i<m_localPlayers.size(); i++)
         {
@@ -490,7 +588,7 @@ void World::updateStep(float delta)
             }
             else
             {
-                m_referee->process(m_ball->m_body, m_level->getBody("level")); 
+                m_referee->process(m_ball->m_body, m_level->m_ground);
             }
         }
 
@@ -501,20 +599,41 @@ void World::update(float delta)
 {
     // update is called one time in frame
 
+    if (m_headless)
+    {
+        m_scoreBoard->update();
+        m_referee->update();
+        m_messages->update(delta);
+        return;
+    }
+
     alListenerfv(AL_POSITION, m_localPlayers[0]->getPosition().v);
     alListenerfv(AL_VELOCITY, m_localPlayers[0]->m_body->getVelocity().v);
 
-    m_camera->update(delta);
-    m_scoreBoard->update();
-    m_referee->update();
-    m_messages->update(delta);
-    m_grass->update(delta);
+    {
+        ProfileZone zone("Camera::update");
+        m_camera->update(delta);
+    }
+    {
+        ProfileZone zone("Referee::update");
+        m_scoreBoard->update();
+        m_referee->update();
+    }
+    {
+        ProfileZone zone("Messages::update");
+        m_messages->update(delta);
+    }
+    {
+        ProfileZone zone("Grass::update");
+        m_grass->update(delta);
+    }
 }
 
 void World::prepare()
 {
     m_camera->prepare();
     m_level->prepare();
+    updateShadowCascades();
 }
 
 void World::render() const
@@ -522,6 +641,8 @@ void World::render() const
     int shadow_type = Config::instance->m_video.shadow_type;
     if (shadow_type == 0)
     {
+        ProfileZone zone("Scene");
+
         m_hdr->begin();
         glClear(GL_DEPTH_BUFFER_BIT);
         m_camera->render();
@@ -540,6 +661,7 @@ void World::render() const
         {
             (*iter)->renderColor();
         }
+        Video::instance->renderSimpleShadows();
         
         glLightfv(GL_LIGHT1, GL_DIFFUSE, (GRASS_BRIGHTNESS_1*Vector::One).v);
         glLightfv(GL_LIGHT1, GL_AMBIENT, (GRASS_BRIGHTNESS_2*Vector::One).v);
@@ -550,13 +672,21 @@ void World::render() const
     {
         // shadow mapping
 
-        shadowMapPass1();
-        m_hdr->begin();
-        shadowMapPass2();
+        {
+            ProfileZone zone("Shadow pass 1", true);
+            shadowMapPass1();
+        }
+        {
+            ProfileZone zone("Shadow pass 2", true);
+            m_hdr->begin();
+            shadowMapPass2();
+        }
     }
     m_hdr->end();
     m_hdr->render();
 
+    ProfileZone zone("Text");
+
     // text messages are last
     if (m_freeze || m_networkPaused)
     {
@@ -571,8 +701,8 @@ void World::render() const
             const Font* font = m_messages->m_fonts.find(i)->second;
             font->begin();
 
-            float w2 = static_cast<float>(font->getWidth(m->getText())) / 2.0f;
-            float h = static_cast<float>(font->getHeight(m->getText()));
+            float w2 = static_cast<float>(m->getWidth(font)) / 2.0f;
+            float h = static_cast<float>(m->getHeight(font));
 
             const Vector& pos = m->getPosition();
 
@@ -595,8 +725,8 @@ void World::render() const
         Message* m = m_referee->m_over;
         const Font* font = m_messages->m_fonts.find(m->getFontSize())->second;
         font->begin();
-        float w = static_cast<float>(font->getWidth(m->getText()));
-        float h = static_cast<float>(font->getHeight(m->getText()));
+        float w = static_cast<float>(m->getWidth(font));
+        float h = static_cast<float>(m->getHeight(font));
 
         const Vector& pos = m->getPosition() - Vector(0.0f, h / 4, 0.0f);
 
@@ -632,20 +762,27 @@ void World::setLight(const Vector& position)
     }
 
     glPushMatrix();
-    
-    glLoadIdentity();
-    //gluPerspective(45.0f, 1.0f, 10.0f, 70.0f);
-    glOrtho(-40.0f, 28.0f, -15.0f, 26.0f, 2.0f, 70.0f);
-    glGetFloatv(GL_MODELVIEW_MATRIX, m_lightProjection.m);
-
     glLoadIdentity();
     gluLookAt(  m_lightPosition.x, m_lightPosition.y, m_lightPosition.z,
                 4.0f, 0.0f, 5.0f,
                 0.0f, 1.0f, 0.0f);
     glGetFloatv(GL_MODELVIEW_MATRIX, m_lightView.m);
-
     glPopMatrix();
 
+    // until camera is known every cascade covers whole level
+    for (int i = 0; i < SHADOW_CASCADES; i++)
+    {
+        m_lightProjection[i] = makeOrtho(SHADOW_LEFT, SHADOW_RIGHT, SHADOW_BOTTOM, SHADOW_TOP, SHADOW_NEAR, SHADOW_FAR);
+    }
+}
+
+void World::updateShadowCascades()
+{
+    if (Config::instance->m_video.shadow_type == 0)
+    {
+        return;
+    }
+
     //Calculate texture matrix for projection
     //This matrix takes us from eye space to the light's clip space
     //It is postmultiplied by the inverse of the current view matrix when specifying texgen
@@ -653,17 +790,61 @@ void World::setLight(const Vector& position)
                                     0.0f, 0.5f, 0.0f, 0.0f,
                                     0.0f, 0.0f, 0.5f, 0.0f,
                                     0.5f, 0.5f, 0.5f, 1.0f);    //bias from [-1, 1] to [0, 1]
-    m_textureMatrix = biasMatrix * m_lightProjection * m_lightView;
 
-    //Bind & enable shadow map texture
-    glActiveTextureARB(GL_TEXTURE1_ARB);
-    //Set up texture coordinate generation.
-    glTexGenfv(GL_S, GL_EYE_PLANE, m_textureMatrix.column(0).v);
-    glTexGenfv(GL_T, GL_EYE_PLANE, m_textureMatrix.column(1).v);
-    glTexGenfv(GL_R, GL_EYE_PLANE, m_textureMatrix.column(2).v);
-    glTexGenfv(GL_Q, GL_EYE_PLANE, m_textureMatrix.column(3).v);
-    glActiveTextureARB(GL_TEXTURE0_ARB);
+    const IntPair res = Video::instance->getResolution();
+    const float tanY = std::tan(CAMERA_FOV / 2 * DEG_IN_RAD);
+    const float tanX = tanY * static_cast<float>(res.first) / static_cast<float>(res.second);
 
+    const Matrix eyeToLight = m_lightView * invertRigid(m_camera->matrix());
+    const float tileSize = static_cast<float>(m_shadowSize / 2);
+
+    float splitNear = CAMERA_NEAR;
+    for (int i = 0; i < SHADOW_CASCADES; i++)
+    {
+        const float splitFar = m_shadowSplits[i];
+
+        Vector corners[8];
+        Vector center(0.0f, 0.0f, 0.0f);
+        for (int k = 0; k < 8; k++)
+        {
+            const float d = (k < 4 ? splitNear : splitFar);
+            const Vector eye((k & 1 ? tanX : -tanX) * d, (k & 2 ? tanY : -tanY) * d, -d);
+            corners[k] = eyeToLight * eye;
+            center += corners[k];
+        }
+        center /= 8.0f;
+
+        // bounding sphere doesn't change size when camera rotates,
+        // so with snapping to texels shadow edges don't swim
+        float radius = 0.0f;
+        for (int k = 0; k < 8; k++)
+        {
+            radius = std::max(radius, (corners[k] - center).magnitude());
+        }
+        const float texel = 2.0f * radius / tileSize;
+
+        float left = std::floor((center.x - radius) / texel) * texel;
+        float bottom = std::floor((center.y - radius) / texel) * texel;
+        float right = left + 2.0f * radius;
+        float top = bottom + 2.0f * radius;
+
+        left = std::max(left, SHADOW_LEFT);
+        bottom = std::max(bottom, SHADOW_BOTTOM);
+        right = std::min(right, SHADOW_RIGHT);
+        top = std::min(top, SHADOW_TOP);
+        if (left >= right || bottom >= top)
+        {
+            left = SHADOW_LEFT;
+            right = SHADOW_RIGHT;
+            bottom = SHADOW_BOTTOM;
+            top = SHADOW_TOP;
+        }
+
+        m_lightProjection[i] = makeOrtho(left, right, bottom, top, SHADOW_NEAR, SHADOW_FAR);
+        m_textureMatrix[i] = biasMatrix * m_lightProjection[i] * m_lightView;
+
+        splitNear = splitFar;
+    }
 }
 
 void World::setupShadowStuff()
@@ -690,8 +871,20 @@ void World::setupShadowStuff()
         return;
     }
 
+    // 2x2 atlas, one tile per cascade
     m_shadowSize = (1 << Config::instance->m_video.shadowmap_size) * 512; // 512, 1024, 2048
 
+    for (int i = 0; i < SHADOW_CASCADES; i++)
+    {
+        float k = static_cast<float>(i + 1) / SHADOW_CASCADES;
+        float logSplit = CAMERA_NEAR * std::pow(SHADOW_DISTANCE / CAMERA_NEAR, k);
+        float uniSplit = CAMERA_NEAR + (SHADOW_DISTANCE - CAMERA_NEAR) * k;
+        m_shadowSplits[i] = SHADOW_SPLIT_LAMBDA * logSplit + (1.0f - SHADOW_SPLIT_LAMBDA) * uniSplit;
+    }
+    m_shadowShader->begin();
+    m_shadowShader->setFloat4("shadow_splits", Vector(m_shadowSplits[0], m_shadowSplits[1], m_shadowSplits[2], 0.0f));
+    m_shadowShader->end();
+
     bool valid = false;
 
     while (!valid)
@@ -761,15 +954,9 @@ void World::shadowMapPass1() const
     glPushAttrib(GL_VIEWPORT_BIT | GL_POLYGON_BIT | GL_LIGHTING_BIT | GL_COLOR_BUFFER_BIT);
     glClear(GL_DEPTH_BUFFER_BIT);
 
-    //Use viewport the same size as the shadow map
-    glViewport(0, 0, m_shadowSize, m_shadowSize);
-
-    //Setup projection and view matrices from light position
     glMatrixMode(GL_PROJECTION);
     glPushMatrix();
-    glLoadMatrixf(m_lightProjection.m);
     glMatrixMode(GL_MODELVIEW);
-    glLoadMatrixf(m_lightView.m);
 
     //Disable color writes, and use flat shading for speed
     glShadeModel(GL_FLAT);
@@ -783,10 +970,22 @@ void World::shadowMapPass1() const
     //glCullFace(GL_BACK);
     //glFrontFace(GL_CCW);
 
-    //Draw the scene
+    //Draw the scene once per cascade, each into its own atlas tile
     glDisable(GL_TEXTURE_2D);
     glDisable(GL_LIGHTING);
-    renderScene();
+    const unsigned int tile = m_shadowSize / 2;
+    for (int i = 0; i < SHADOW_CASCADES; i++)
+    {
+        glViewport((i % 2) * tile, (i / 2) * tile, tile, tile);
+
+        //Setup projection and view matrices from light position
+        glMatrixMode(GL_PROJECTION);
+        glLoadMatrixf(m_lightProjection[i].m);
+        glMatrixMode(GL_MODELVIEW);
+        glLoadMatrixf(m_lightView.m);
+
+        renderScene();
+    }
     glEnable(GL_TEXTURE_2D);
    
     //restore states
@@ -831,11 +1030,15 @@ void World::shadowMapPass2() const
     //Bind & enable shadow map texture
     glActiveTextureARB(GL_TEXTURE1_ARB);
     glBindTexture(GL_TEXTURE_2D, m_shadowTex);
-    //Set up texture coordinate generation.
-    glTexGenfv(GL_S, GL_EYE_PLANE, m_textureMatrix.column(0).v);
-    glTexGenfv(GL_T, GL_EYE_PLANE, m_textureMatrix.column(1).v);
-    glTexGenfv(GL_R, GL_EYE_PLANE, m_textureMatrix.column(2).v);
-    glTexGenfv(GL_Q, GL_EYE_PLANE, m_textureMatrix.column(3).v);
+    //Set up texture coordinate generation, cascade i uses eye planes of unit 1+i
+    for (int i = 0; i < SHADOW_CASCADES; i++)
+    {
+        glActiveTextureARB(GL_TEXTURE1_ARB + i);
+        glTexGenfv(GL_S, GL_EYE_PLANE, m_textureMatrix[i].column(0).v);
+        glTexGenfv(GL_T, GL_EYE_PLANE, m_textureMatrix[i].column(1).v);
+        glTexGenfv(GL_R, GL_EYE_PLANE, m_textureMatrix[i].column(2).v);
+        glTexGenfv(GL_Q, GL_EYE_PLANE, m_textureMatrix[i].column(3).v);
+    }
     glActiveTextureARB(GL_TEXTURE0_ARB);
 
     m_shadowShader->begin();
@@ -854,6 +1057,7 @@ void World::shadowMapPass2() const
     {
         (*iter)->renderColor();
     }
+    Video::instance->renderSimpleShadows();
 
     //Restore states
     glPopAttrib();
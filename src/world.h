@@ -29,13 +29,18 @@ class Shader;
 
 typedef vector<Profile*> ProfilesVector;
 
+static const int SHADOW_CASCADES = 3;
+
 class World : public State, public System<World>
 {
 public:
-    World(Profile* userProfile, int& unlockable, int current);
+    // headless world has no rendering, audio or input, only simulation
+    World(Profile* userProfile, int& unlockable, int current, bool headless = false);
     ~World();
 
     void init();
+    void load();  // can run in loader thread
+    void start(); // main thread, after load
     
     void control();
     void updateStep(float delta);
@@ -61,6 +66,7 @@ private:
     int&           m_unlockable;
 
     bool           m_freeze;
+    bool           m_headless;
     Profile*       m_userProfile;
     Message*       m_escMessage;
 
@@ -68,9 +74,10 @@ private:
 
     // all below is shadow stuff
     Vector           m_lightPosition;
-    Matrix           m_lightProjection;
     Matrix           m_lightView;
-    Matrix           m_textureMatrix;
+    Matrix           m_lightProjection[SHADOW_CASCADES];
+    Matrix           m_textureMatrix[SHADOW_CASCADES];
+    float            m_shadowSplits[SHADOW_CASCADES];
 
     unsigned int     m_shadowTex;
     unsigned int     m_shadowSize;
@@ -78,6 +85,7 @@ private:
     HDR*             m_hdr;
 
     void setLight(const Vector& position);
+    void updateShadowCascades();
 
     void setupShadowStuff();
     void killShadowStuff();
@@ -2,6 +2,8 @@
 #include <ostream>
 #include <sstream>
 #include <iomanip>
+#include <cstring>
+#include <new>
 
 #include <expat.h>
 
@@ -191,3 +193,194 @@ void XMLnode::load(File::Reader& reader)
     XMLreader xmlReader(reader);
     xmlReader.parse(*this);
 }
+
+/** READ ONLY DOM **/
+
+static bool isSpace(char c)
+{
+    return c=='\n' || c=='\t' || c==' ' || c=='\r';
+}
+
+class XMLdocument::Parser
+{
+private:
+    XMLdocument&        m_document;
+    XML_Parser          m_parser;
+
+    vector<XMLelement*> m_elements;
+    vector<size_t>      m_textStart;
+    vector<char>        m_text; // text of all open elements
+
+    static const size_t BUFSIZE = 16384;
+
+    static void XMLCALL StartElementHandler(void *userData, const XML_Char *name, const XML_Char **atts)
+    {
+        Parser* self = static_cast<Parser*>(userData);
+        XMLdocument& document = self->m_document;
+
+        unsigned int line = XML_GetCurrentLineNumber(self->m_parser);
+        XMLelement* parent = (self->m_elements.empty() ? NULL : self->m_elements.back());
+        XMLelement* node = document.addElement(parent, document.intern(name), line);
+
+        // attributes are prepended, so add them backwards to keep document order
+        int count = 0;
+        while (atts[count] != NULL)
+        {
+            count += 2;
+        }
+        for (int i = count - 2; i >= 0; i -= 2)
+        {
+            document.addAttribute(node, document.intern(atts[i]), document.copy(atts[i + 1], strlen(atts[i + 1])));
+        }
+
+        self->m_elements.push_back(node);
+        self->m_textStart.push_back(self->m_text.size());
+    }
+
+    static void XMLCALL EndElementHandler(void *userData, const XML_Char *name)
+    {
+        Parser* self = static_cast<Parser*>(userData);
+
+        size_t i = self->m_textStart.back();
+        size_t j = self->m_text.size();
+        while (i < j && isSpace(self->m_text[i]))
+        {
+            i++;
+        }
+        while (j > i && isSpace(self->m_text[j-1]))
+        {
+            j--;
+        }
+        if (i < j)
+        {
+            self->m_elements.back()->value = self->m_document.copy(&self->m_text[i], j - i);
+        }
+
+        self->m_text.resize(self->m_textStart.back());
+        self->m_textStart.pop_back();
+        self->m_elements.pop_back();
+    }
+
+    static void XMLCALL CharacterDataHandler(void *userData, const XML_Char *s, int len)
+    {
+        Parser* self = static_cast<Parser*>(userData);
+        self->m_text.insert(self->m_text.end(), s, s + len);
+    }
+
+public:
+    Parser(XMLdocument& document) : m_document(document)
+    {
+        m_parser = XML_ParserCreate(NULL);
+        if (m_parser == NULL)
+        {
+            throw Exception("Error creating XML parser");
+        }
+
+        XML_SetUserData(m_parser, static_cast<void*>(this));
+        XML_SetStartElementHandler(m_parser, StartElementHandler);
+        XML_SetEndElementHandler(m_parser, EndElementHandler);
+        XML_SetCharacterDataHandler(m_parser, CharacterDataHandler);
+    }
+
+    ~Parser()
+    {
+        XML_ParserFree(m_parser);
+    }
+
+    void parse(File::Reader& reader)
+    {
+        while (! reader.eof())
+        {
+            void* buffer = XML_GetBuffer(m_parser, BUFSIZE);
+            if (buffer == NULL)
+            {
+                throw Exception("Error alocating buffer for xml parsing");
+            }
+
+            size_t read = reader.read(buffer, BUFSIZE);
+         
+            if (XML_ParseBuffer(m_parser, static_cast<int>(read), reader.eof() || read==0 ? 1 : 0) == XML_STATUS_ERROR)
+            {
+                int c = static_cast<int>(XML_GetErrorColumnNumber(m_parser));
+                int l = static_cast<int>(XML_GetErrorLineNumber(m_parser));
+                const XML_LChar* err = XML_ErrorString(XML_GetErrorCode(m_parser));
+                throw Exception("XML parser error (" + cast<string>(l) + ", " + cast<string>(c) + "): " + string(err));
+            }
+        }
+    }
+};
+
+XMLdocument::XMLdocument() : m_root(NULL)
+{
+}
+
+void XMLdocument::load(File::Reader& reader)
+{
+    clear();
+
+    Parser parser(*this);
+    parser.parse(reader);
+
+    if (m_root == NULL)
+    {
+        throw Exception("XML document is empty");
+    }
+}
+
+const XMLelement& XMLdocument::root() const
+{
+    return *m_root;
+}
+
+void XMLdocument::clear()
+{
+    m_root = NULL;
+    m_arena.clear();
+}
+
+const string& XMLdocument::intern(const char* name)
+{
+    return *m_names.insert(name).first;
+}
+
+const char* XMLdocument::copy(const char* text, size_t length)
+{
+    return m_arena.copy(text, length);
+}
+
+XMLelement* XMLdocument::addElement(XMLelement* parent, const string& name, unsigned int line)
+{
+    XMLelement* element = new (m_arena.allocate(sizeof(XMLelement))) XMLelement(name, line);
+
+    if (parent == NULL)
+    {
+        m_root = element;
+    }
+    else
+    {
+        XMLelements& childs = parent->childs;
+        if (childs.m_last == NULL)
+        {
+            childs.m_first = element;
+        }
+        else
+        {
+            childs.m_last->m_next = element;
+        }
+        childs.m_last = element;
+        childs.m_size++;
+    }
+    return element;
+}
+
+XMLattribute* XMLdocument::addAttribute(XMLelement* element, const string& name, const char* value)
+{
+    XMLattribute* attribute = static_cast<XMLattribute*>(m_arena.allocate(sizeof(XMLattribute)));
+    attribute->name = &name;
+    attribute->value = value;
+    attribute->next = element->m_attributes;
+    attribute->numeric = false;
+    attribute->number = 0.0f;
+    element->m_attributes = attribute;
+    return attribute;
+}
@@ -4,6 +4,8 @@
 #include "common.h"
 #include "file.h"
 #include "vmath.h"
+#include "arena.h"
+#include "utilities.h"
 
 class XMLnode;
 
@@ -12,6 +14,35 @@ typedef vector<XMLnode> XMLnodes;
 class XMLreader;
 class XMLwriter;
 
+// numbers are parsed without stringstream, cast is used only for
+// other types and for values that are not plain numbers
+template <typename T>
+inline T parseAttribute(const char* value)
+{
+    return cast<T>(value);
+}
+
+template <>
+inline float parseAttribute<float>(const char* value)
+{
+    float result;
+    return parseNumber(value, result) ? result : cast<float>(value);
+}
+
+template <>
+inline int parseAttribute<int>(const char* value)
+{
+    int result;
+    return parseNumber(value, result) ? result : cast<int>(value);
+}
+
+template <>
+inline unsigned int parseAttribute<unsigned int>(const char* value)
+{
+    unsigned int result;
+    return parseNumber(value, result) ? result : cast<unsigned int>(value);
+}
+
 class XMLnode
 {
     friend void outputNode(const XMLnode& node, std::ostream& stream, int level);
@@ -63,7 +94,7 @@ T XMLnode::getAttribute(const string& name) const
     StringMap::const_iterator iter = attributes.find(name);
     if (iter != attributes.end())
     {
-        return cast<T>(iter->second);
+        return parseAttribute<T>(iter->second.c_str());
     }
 
     throw Exception("Missing attribute '" + name + "' in node '" + name + "' at line " + cast<string>(line));
@@ -86,7 +117,7 @@ T XMLnode::getAttribute(const string& name, T defaultValue) const
     StringMap::const_iterator iter = attributes.find(name);
     if (iter != attributes.end())
     {
-        return cast<T>(iter->second);
+        return parseAttribute<T>(iter->second.c_str());
     }
     return defaultValue;
 }
@@ -110,12 +141,278 @@ Vector XMLnode::getAttributesInVector(const string& attributeSymbols) const
 {
     assert(attributeSymbols.size() < 5);
     Vector vector;
+    string key(1, ' ');
     for (size_t i = 0; i < attributeSymbols.size(); i++)
     {
-        string key(1, attributeSymbols[i]);
+        key[0] = attributeSymbols[i];
         vector[i] = getAttribute<float>(key);
     }
     return vector;
 }
 
+/** READ ONLY DOM **/
+
+// nodes, attributes and text are allocated from document arena,
+// element and attribute names are interned in document
+
+class XMLelement;
+class XMLdocument;
+
+struct XMLattribute
+{
+    const string*       name;
+    const char*         value;
+    const XMLattribute* next;
+
+    // value already converted to number (compiled levels)
+    bool                numeric;
+    float               number;
+};
+
+class XMLelements
+{
+    friend class XMLdocument;
+public:
+    class const_iterator
+    {
+    public:
+        const_iterator(const XMLelement* element = NULL) : m_element(element) {}
+
+        inline const XMLelement& operator * () const;
+        inline const XMLelement* operator -> () const;
+        inline const_iterator& operator ++ ();
+        inline const_iterator operator ++ (int);
+
+        bool operator == (const const_iterator& other) const { return m_element == other.m_element; }
+        bool operator != (const const_iterator& other) const { return m_element != other.m_element; }
+
+    private:
+        const XMLelement* m_element;
+    };
+
+    XMLelements() : m_first(NULL), m_last(NULL), m_size(0) {}
+
+    const_iterator begin() const { return const_iterator(m_first); }
+    const_iterator end() const { return const_iterator(); }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+private:
+    XMLelement* m_first;
+    XMLelement* m_last;
+    size_t      m_size;
+};
+
+class XMLelement
+{
+    friend class XMLdocument;
+    friend class XMLelements::const_iterator;
+public:
+    XMLelement(const string& name, unsigned int line) :
+        name(name), value(""), line(line), m_attributes(NULL), m_next(NULL) {}
+
+    XMLelements   childs;
+    const string& name;
+    const char*   value;
+    unsigned int  line;
+
+    inline bool hasAttributes() const;
+    inline bool hasAttribute(const string& name) const;
+    const XMLattribute* attributes() const { return m_attributes; }
+
+    template <typename T>
+    inline T getAttribute(const string& name) const;
+    inline string getAttribute(const string& name) const;
+
+    template <typename T>
+    inline T getAttribute(const string& name, T defaultValue) const;
+    inline string getAttribute(const string& name, const string& defaultValue) const;
+    inline Vector getAttributesInVector(const string& attributeSymbols) const;
+
+private:
+    const XMLattribute* m_attributes;
+    XMLelement*         m_next;
+
+    inline const XMLattribute* find(const string& name) const;
+    inline const XMLattribute* find(char name) const;
+    inline const char* findAttribute(const string& name) const;
+    inline float getNumber(const XMLattribute* attribute) const;
+};
+
+class XMLdocument : public NoCopy
+{
+public:
+    XMLdocument();
+
+    void load(File::Reader& reader);
+
+    const XMLelement& root() const;
+
+    // building document without xml parsing, attributes are prepended
+    void clear();
+    const string& intern(const char* name);
+    const char* copy(const char* text, size_t length);
+    XMLelement* addElement(XMLelement* parent, const string& name, unsigned int line);
+    XMLattribute* addAttribute(XMLelement* element, const string& name, const char* value);
+
+private:
+    class Parser;
+    friend class Parser;
+
+    Arena       m_arena;
+    StringSet   m_names;
+    XMLelement* m_root;
+};
+
+const XMLelement& XMLelements::const_iterator::operator * () const
+{
+    return *m_element;
+}
+
+const XMLelement* XMLelements::const_iterator::operator -> () const
+{
+    return m_element;
+}
+
+XMLelements::const_iterator& XMLelements::const_iterator::operator ++ ()
+{
+    m_element = m_element->m_next;
+    return *this;
+}
+
+XMLelements::const_iterator XMLelements::const_iterator::operator ++ (int)
+{
+    const_iterator result = *this;
+    m_element = m_element->m_next;
+    return result;
+}
+
+const XMLattribute* XMLelement::find(const string& name) const
+{
+    for (const XMLattribute* attribute = m_attributes; attribute != NULL; attribute = attribute->next)
+    {
+        if (*attribute->name == name)
+        {
+            return attribute;
+        }
+    }
+    return NULL;
+}
+
+const XMLattribute* XMLelement::find(char name) const
+{
+    for (const XMLattribute* attribute = m_attributes; attribute != NULL; attribute = attribute->next)
+    {
+        if (attribute->name->size() == 1 && (*attribute->name)[0] == name)
+        {
+            return attribute;
+        }
+    }
+    return NULL;
+}
+
+float XMLelement::getNumber(const XMLattribute* attribute) const
+{
+    return attribute->numeric ? attribute->number : parseAttribute<float>(attribute->value);
+}
+
+const char* XMLelement::findAttribute(const string& name) const
+{
+    const XMLattribute* attribute = find(name);
+    return (attribute != NULL ? attribute->value : NULL);
+}
+
+bool XMLelement::hasAttributes() const
+{
+    return m_attributes != NULL;
+}
+
+bool XMLelement::hasAttribute(const string& name) const
+{
+    return findAttribute(name) != NULL;
+}
+
+template <typename T>
+T XMLelement::getAttribute(const string& name) const
+{
+    const char* value = findAttribute(name);
+    if (value != NULL)
+    {
+        return parseAttribute<T>(value);
+    }
+
+    throw Exception("Missing attribute '" + name + "' in node '" + this->name + "' at line " + cast<string>(line));
+}
+
+string XMLelement::getAttribute(const string& name) const
+{
+    const char* value = findAttribute(name);
+    if (value != NULL)
+    {
+        return value;
+    }
+
+    throw Exception("Missing attribute '" + name + "' in node '" + this->name + "' at line " + cast<string>(line));
+}
+
+template <typename T>
+T XMLelement::getAttribute(const string& name, T defaultValue) const
+{
+    const char* value = findAttribute(name);
+    if (value != NULL)
+    {
+        return parseAttribute<T>(value);
+    }
+    return defaultValue;
+}
+
+template <>
+inline float XMLelement::getAttribute<float>(const string& name) const
+{
+    const XMLattribute* attribute = find(name);
+    if (attribute != NULL)
+    {
+        return getNumber(attribute);
+    }
+
+    throw Exception("Missing attribute '" + name + "' in node '" + this->name + "' at line " + cast<string>(line));
+}
+
+template <>
+inline float XMLelement::getAttribute<float>(const string& name, float defaultValue) const
+{
+    const XMLattribute* attribute = find(name);
+    if (attribute != NULL)
+    {
+        return getNumber(attribute);
+    }
+    return defaultValue;
+}
+
+string XMLelement::getAttribute(const string& name, const string& defaultValue) const
+{
+    const char* value = findAttribute(name);
+    if (value != NULL)
+    {
+        return value;
+    }
+    return defaultValue;
+}
+
+Vector XMLelement::getAttributesInVector(const string& attributeSymbols) const
+{
+    assert(attributeSymbols.size() < 5);
+    Vector vector;
+    for (size_t i = 0; i < attributeSymbols.size(); i++)
+    {
+        const XMLattribute* attribute = find(attributeSymbols[i]);
+        if (attribute == NULL)
+        {
+            throw Exception("Missing attribute '" + string(1, attributeSymbols[i]) + "' in node '" + name + "' at line " + cast<string>(line));
+        }
+        vector[i] = getNumber(attribute);
+    }
+    return vector;
+}
+
 #endif // __XML_H__
@@ -0,0 +1,66 @@
+import os
+import sys
+import struct
+
+# usage: packData.py [data dir] [output file]
+# packs all data files in one memory mappable data.pak, see File::init
+
+DATA_PATH = os.path.join("..", "bin", "data")
+PACK_FILE = os.path.join("..", "bin", "data.pak")
+
+MAGIC = "S3DP"
+VERSION = 1
+ALIGNMENT = 16
+HEADER_SIZE = 16
+ENTRY_SIZE = 24
+COMPRESSION_NONE = 0
+
+def fnv1a(name):
+  h = 2166136261L
+  for c in name:
+    h = ((h ^ ord(c)) * 16777619) & 0xFFFFFFFFL
+  return h
+
+def align(offset):
+  return (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT
+
+def collect(root):
+  names = []
+  for path, dirs, files in os.walk(root):
+    dirs[:] = [d for d in dirs if not d.startswith(".")]
+    for f in files:
+      if f.startswith("."): continue
+      full = os.path.join(path, f)
+      names.append(os.path.relpath(full, root).replace(os.sep, "/"))
+  return names
+
+root = len(sys.argv) > 1 and sys.argv[1] or DATA_PATH
+output = len(sys.argv) > 2 and sys.argv[2] or PACK_FILE
+
+names = collect(root)
+names.sort(key = lambda name: (fnv1a(name), name))
+
+nameOffset = HEADER_SIZE + ENTRY_SIZE * len(names)
+namesBlob = "".join(names)
+offset = align(nameOffset + len(namesBlob))
+
+entries = []
+for name in names:
+  size = os.path.getsize(os.path.join(root, name))
+  entries.append((fnv1a(name), nameOffset, len(name), offset, size, COMPRESSION_NONE))
+  nameOffset += len(name)
+  offset = align(offset + size)
+
+out = file(output, "wb")
+out.write(MAGIC + struct.pack("<3I", VERSION, len(entries), 0))
+for e in entries:
+  out.write(struct.pack("<6I", *e))
+out.write(namesBlob)
+for name, e in zip(names, entries):
+  out.write("\0" * (e[3] - out.tell()))
+  f = file(os.path.join(root, name), "rb")
+  out.write(f.read())
+  f.close()
+out.close()
+
+print "Packed %i files in '%s'" % (len(entries), output)
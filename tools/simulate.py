@@ -0,0 +1,52 @@
+import os
+import sys
+import subprocess
+
+# usage: simulate.py <matches> [processes]
+# runs headless AI matches in parallel processes and merges their results
+
+BIN_PATH = os.path.join("..", "bin")
+
+def executable():
+  for name in ["Squares3D.exe", "Squares3D"]:
+    path = os.path.join(BIN_PATH, name)
+    if os.path.exists(path): return os.path.abspath(path)
+  raise "ERROR!!! Squares3D executable not found"
+
+matches = int(sys.argv[1])
+count = len(sys.argv) > 2 and int(sys.argv[2]) or 4
+
+exe = executable()
+processes = []
+for i in range(count):
+  n = matches / count + (i < matches % count and 1 or 0)
+  seed = 1000 + i
+  processes.append(subprocess.Popen([exe, "--simulate", str(n), str(seed)], cwd=BIN_PATH, stdout=subprocess.PIPE))
+
+stats = {}
+unfinished = 0
+ticks = 0
+seconds = 0.0
+for p in processes:
+  for line in p.stdout.read().splitlines():
+    x = line.split("\t")
+    if x[0] == "profile":
+      s = stats.setdefault(x[1], [0, 0, 0])
+      for k in range(3): s[k] += int(x[2+k])
+    elif x[0] == "unfinished":
+      unfinished += int(x[1])
+    elif x[0] == "ticks":
+      ticks += int(x[1])
+      seconds = max(seconds, float(x[2]))
+  p.wait()
+
+print "%-16s %8s %8s %8s %10s" % ("profile", "matches", "losses", "lose %", "points")
+names = stats.keys()
+names.sort(key=lambda name: float(stats[name][1]) / stats[name][0])
+for name in names:
+  s = stats[name]
+  print "%-16s %8i %8i %8.1f %10.2f" % (name, s[0], s[1], 100.0 * s[1] / s[0], float(s[2]) / s[0])
+
+print
+print "unfinished matches: %i" % unfinished
+if seconds > 0: print "simulated %i ticks in %.1f seconds = %.0f ticks per second" % (ticks, seconds, ticks / seconds)